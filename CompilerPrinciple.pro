@@ -9,21 +9,69 @@ CONFIG += c++17, debug
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    arena.cpp \
+    benchmark.cpp \
+    dfascanner.cpp \
+    diagnostics.cpp \
+    highlighter.cpp \
+    irfile.cpp \
+    lalrparser.cpp \
+    lineindex.cpp \
+    lspserver.cpp \
     main.cpp \
     mainwindow.cpp \
     parser.cpp \
+    parsercheck.cpp \
+    pipeline.cpp \
+    preprocessor.cpp \
+    quad.cpp \
     scanner.cpp \
-    token.cpp
+    scannercheck.cpp \
+    scheduler.cpp \
+    sourcetext.cpp \
+    structuralindex.cpp \
+    symboltable.cpp \
+    token.cpp \
+    tokentablemodel.cpp
 
 HEADERS += \
+    arena.h \
+    benchmark.h \
+    dfascanner.h \
+    diagnostics.h \
+    highlighter.h \
+    irfile.h \
+    lalrparser.h \
+    lalrtables.h \
+    lineindex.h \
+    lspserver.h \
     mainwindow.h \
     parser.h \
+    parsercheck.h \
+    pipeline.h \
+    preprocessor.h \
+    quad.h \
     scanner.h \
-    token.h
+    scannercheck.h \
+    scheduler.h \
+    sourcetext.h \
+    structuralindex.h \
+    symboltable.h \
+    token.h \
+    tokentablemodel.h
 
 FORMS += \
     mainwindow.ui
 
+# LALR(1) 分析表由 tools/lalrgen 根据 tools/c_subset.grammar 生成，生成的 lalrtables.h
+# 随源码提交，构建时不需要生成器。修改文法后执行 make lalrtables 重新生成。
+lalrtables.commands = $$QMAKE_CXX -std=c++17 -O2 -o $$OUT_PWD/lalrgen $$PWD/tools/lalrgen.cpp && \
+                      $$OUT_PWD/lalrgen $$PWD/tools/c_subset.grammar $$PWD/lalrtables.h
+QMAKE_EXTRA_TARGETS += lalrtables
+OTHER_FILES += \
+    tools/c_subset.grammar \
+    tools/lalrgen.cpp
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
@@ -0,0 +1,67 @@
+#include "arena.h"
+#include <algorithm>
+
+namespace {
+
+// 每个 Token 在结构索引中约占 8 字节（配对表与同步点表），另留语义栈与分块记录的余量
+constexpr qsizetype BYTES_PER_TOKEN = 16;
+constexpr qsizetype MIN_BYTES = 4096;
+
+} // namespace
+
+CompileArena::CompileArena()
+    : blockSize(0)
+{
+    memory.emplace(&overflow);
+}
+
+void CompileArena::reset(qsizetype sourceChars)
+{
+    // 上一次会话溢出到堆上的部分并入预留块，预留块只增不减
+    const qsizetype needed = std::max(estimateBytes(sourceChars),
+                                      blockSize + static_cast<qsizetype>(overflow.requested));
+    memory.reset();
+    overflow.requested = 0;
+    if (needed > blockSize) {
+        block.reset(new std::byte[static_cast<std::size_t>(needed)]);
+        blockSize = needed;
+    }
+    memory.emplace(block.get(), static_cast<std::size_t>(blockSize), &overflow);
+}
+
+std::pmr::memory_resource* CompileArena::resource()
+{
+    return &*memory;
+}
+
+qsizetype CompileArena::capacity() const
+{
+    return blockSize;
+}
+
+qsizetype CompileArena::estimateTokens(qsizetype sourceChars)
+{
+    // 典型 C 源码平均每 4 个字符一个 Token
+    return sourceChars / 4 + 1;
+}
+
+qsizetype CompileArena::estimateBytes(qsizetype sourceChars)
+{
+    return std::max(MIN_BYTES, estimateTokens(sourceChars) * BYTES_PER_TOKEN);
+}
+
+void* CompileArena::OverflowResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    requested += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void CompileArena::OverflowResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+{
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool CompileArena::OverflowResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
@@ -0,0 +1,76 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <QtGlobal>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+/**
+ * @class CompileArena
+ * @brief 一次编译会话使用的单调内存池（std::pmr::monotonic_buffer_resource）。
+ *
+ * 会话开始时按源码长度预留一整块内存，结构索引、语义栈等按会话生存的数据都从中
+ * 顺序切分，释放时整块归还；下一次编译调用 reset() 复用同一块内存，不再逐个向
+ * 全局堆申请和释放。预留不足时向堆申请的部分会被记下，下次 reset() 时并入预留块，
+ * 使同一文件反复编译时的内存占用趋于稳定。
+ *
+ * 内存池本身不是线程安全的，只能由一个线程使用；并行分析的工作线程各自使用局部内存池。
+ */
+class CompileArena {
+public:
+    CompileArena();
+
+    CompileArena(const CompileArena&) = delete;
+    CompileArena& operator=(const CompileArena&) = delete;
+
+    /**
+     * @brief 开始新的编译会话：整体释放上一次会话的内存，并确保预留容量足够。
+     *
+     * 调用前必须确保上一次会话中从本内存池分配的对象都已析构。
+     * @param sourceChars 源代码长度（UTF-16 码元数），用于估算所需容量。
+     */
+    void reset(qsizetype sourceChars);
+
+    /**
+     * @brief 返回当前会话的内存资源。
+     */
+    std::pmr::memory_resource* resource();
+
+    /**
+     * @brief 返回预留块的字节数。
+     */
+    qsizetype capacity() const;
+
+    /**
+     * @brief 按源代码长度估算 Token 数量。
+     */
+    static qsizetype estimateTokens(qsizetype sourceChars);
+
+    /**
+     * @brief 按源代码长度估算一次会话所需的字节数。
+     */
+    static qsizetype estimateBytes(qsizetype sourceChars);
+
+private:
+    /**
+     * @brief 预留块用尽后的上游资源，转发给全局堆并统计申请的字节数。
+     */
+    class OverflowResource : public std::pmr::memory_resource {
+    public:
+        std::size_t requested = 0; ///< 本次会话向堆申请的字节数。
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    std::unique_ptr<std::byte[]> block;                        ///< 预留块。
+    qsizetype blockSize;                                       ///< 预留块的字节数。
+    OverflowResource overflow;                                 ///< 上游资源。
+    std::optional<std::pmr::monotonic_buffer_resource> memory; ///< 当前会话的内存池。
+};
+
+#endif // ARENA_H
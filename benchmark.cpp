@@ -0,0 +1,218 @@
+#include "benchmark.h"
+#include "mainwindow.h"
+#include "tokentablemodel.h"
+#include <QApplication>
+#include <QEventLoop>
+#include <QKeyEvent>
+#include <QPlainTextEdit>
+#include <QTabWidget>
+#include <QTableView>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+// 默认测试的源码字符数与每个大小的按键次数
+const QVector<int> DEFAULT_SIZES = {10000, 100000, 1000000, 5000000};
+constexpr int DEFAULT_EDITS = 40;
+
+// 一个合成函数，%1 为编号
+const char *const SYNTHETIC_FUNCTION =
+    "int f%1() {\n"
+    "    int a = %1;\n"
+    "    int b = a * 2 + 1;\n"
+    "    if (b > 10) {\n"
+    "        b = b - 1;\n"
+    "    }\n"
+    "    return b;\n"
+    "}\n";
+
+} // namespace
+
+LatencyBenchmark::LatencyBenchmark(MainWindow *window, const QStringList &arguments, QObject *parent)
+    : QObject(parent)
+    , window(window)
+    , editor(nullptr)
+    , model(nullptr)
+    , sizes(DEFAULT_SIZES)
+    , edits(DEFAULT_EDITS)
+    , budget(0)
+    , lastPulse(0)
+    , editStart(-1)
+    , firstChunkMs(-1)
+    , current(nullptr)
+{
+    for (int i = 0; i + 1 < arguments.size(); ++i) {
+        const QString &option = arguments[i];
+        const QString &value = arguments[i + 1];
+        if (option == "--sizes") {
+            sizes.clear();
+            for (const QString &size : value.split(',', Qt::SkipEmptyParts)) sizes.append(size.toInt());
+        } else if (option == "--edits") {
+            edits = value.toInt();
+        } else if (option == "--budget") {
+            budget = value.toDouble();
+        }
+    }
+
+    pulse.setInterval(1);
+    pulse.setTimerType(Qt::PreciseTimer);
+    connect(&pulse, &QTimer::timeout, this, &LatencyBenchmark::heartbeat);
+}
+
+int LatencyBenchmark::run()
+{
+    QTabWidget *tabs = window->findChild<QTabWidget *>("documentTabWidget");
+    QTableView *table = window->findChild<QTableView *>("scannerTableView");
+    editor = tabs ? qobject_cast<QPlainTextEdit *>(tabs->currentWidget()) : nullptr;
+    model = table ? qobject_cast<TokenTableModel *>(table->model()) : nullptr;
+    if (editor == nullptr || model == nullptr) {
+        QTextStream(stderr) << "benchmark: 找不到编辑器或 Token 表\n";
+        return 2;
+    }
+
+    connect(model, &QAbstractItemModel::rowsInserted, this, [this]() {
+        if (editStart >= 0 && firstChunkMs < 0) firstChunkMs = (clock.nsecsElapsed() - editStart) / 1e6;
+    });
+
+    QTextStream out(stdout);
+    out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+               .arg("chars", 9).arg("handling p50/p95/p99", 24).arg("first chunk p50/p95/p99", 24)
+               .arg("full table p50/p95/p99", 24).arg("blocked", 9).arg("max stall", 10)
+               .arg("peak RSS", 10);
+    out.flush();
+
+    clock.start();
+    bool withinBudget = true;
+    for (int chars : sizes) {
+        const Samples samples = measure(chars);
+        report(chars, samples);
+        if (samples.timeouts > 0) withinBudget = false;
+        if (budget > 0 && percentile(samples.fullTable, 0.95) > budget) withinBudget = false;
+    }
+    return withinBudget ? 0 : 1;
+}
+
+QString LatencyBenchmark::syntheticSource(int chars)
+{
+    QString source;
+    source.reserve(chars + 256);
+    for (int i = 0; source.size() < chars; ++i) {
+        source += QString(SYNTHETIC_FUNCTION).arg(i);
+    }
+    return source;
+}
+
+bool LatencyBenchmark::waitForScan(int timeoutMs)
+{
+    QEventLoop loop;
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    connect(&timeout, &QTimer::timeout, &loop, [&loop]() { loop.exit(1); });
+    connect(model, &TokenTableModel::scanCompleted, &loop, [&loop]() { loop.exit(0); });
+    timeout.start(timeoutMs);
+    return loop.exec() == 0;
+}
+
+LatencyBenchmark::Samples LatencyBenchmark::measure(int chars)
+{
+    Samples samples;
+
+    // 载入本身不计入测量
+    const QString source = syntheticSource(chars);
+    editor->setPlainText(source);
+    if (!waitForScan(SCAN_TIMEOUT_MS)) {
+        samples.timeouts = edits;
+        return samples;
+    }
+
+    // 光标放在文档中部某个函数体的行首，交替输入空格与退格，源码始终保持合法
+    const int anchor = source.indexOf("    int b", source.size() / 2);
+    QTextCursor cursor = editor->textCursor();
+    cursor.setPosition(qMax(0, anchor));
+    editor->setTextCursor(cursor);
+
+    current = &samples;
+    lastPulse = clock.nsecsElapsed();
+    pulse.start();
+    for (int i = 0; i < edits; ++i) {
+        const bool insert = i % 2 == 0;
+        const int key = insert ? Qt::Key_Space : Qt::Key_Backspace;
+        const QString text = insert ? QString(" ") : QString();
+        QKeyEvent press(QEvent::KeyPress, key, Qt::NoModifier, text);
+        QKeyEvent release(QEvent::KeyRelease, key, Qt::NoModifier, text);
+
+        firstChunkMs = -1;
+        editStart = clock.nsecsElapsed();
+        QApplication::sendEvent(editor, &press);
+        QApplication::sendEvent(editor, &release);
+        samples.handling.append((clock.nsecsElapsed() - editStart) / 1e6);
+
+        if (!waitForScan(SCAN_TIMEOUT_MS)) {
+            ++samples.timeouts;
+        } else {
+            samples.fullTable.append((clock.nsecsElapsed() - editStart) / 1e6);
+            // 后台文档或大文件可能不逐块发布，此时首批即完整结果
+            samples.firstChunk.append(firstChunkMs >= 0 ? firstChunkMs : samples.fullTable.last());
+        }
+        editStart = -1;
+    }
+    pulse.stop();
+    current = nullptr;
+    return samples;
+}
+
+void LatencyBenchmark::heartbeat()
+{
+    const qint64 now = clock.nsecsElapsed();
+    const double gap = (now - lastPulse) / 1e6;
+    lastPulse = now;
+    if (current == nullptr || gap <= STALL_MS) return;
+    current->blocked += gap;
+    current->maxStall = qMax(current->maxStall, gap);
+}
+
+void LatencyBenchmark::report(int chars, const Samples &samples) const
+{
+    auto triple = [](const QVector<double> &values) {
+        return QString("%1/%2/%3").arg(percentile(values, 0.50), 0, 'f', 1)
+                                  .arg(percentile(values, 0.95), 0, 'f', 1)
+                                  .arg(percentile(values, 0.99), 0, 'f', 1);
+    };
+    QTextStream out(stdout);
+    out << QString("%1 %2 %3 %4 %5 %6 %7")
+               .arg(chars, 9).arg(triple(samples.handling), 24).arg(triple(samples.firstChunk), 24)
+               .arg(triple(samples.fullTable), 24).arg(QString::number(samples.blocked, 'f', 1), 9)
+               .arg(QString::number(samples.maxStall, 'f', 1), 10)
+               .arg(QString("%1 MB").arg(peakRssKb() / 1024), 10);
+    if (samples.timeouts > 0) out << QString("  (%1 次超时)").arg(samples.timeouts);
+    out << "\n";
+}
+
+double LatencyBenchmark::percentile(QVector<double> samples, double p)
+{
+    if (samples.isEmpty()) return 0;
+    std::sort(samples.begin(), samples.end());
+    const int rank = static_cast<int>(std::ceil(p * samples.size()));
+    return samples[qBound(0, rank - 1, static_cast<int>(samples.size()) - 1)];
+}
+
+long LatencyBenchmark::peakRssKb()
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef Q_OS_MACOS
+    return usage.ru_maxrss / 1024; // macOS 以字节为单位
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,114 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+class MainWindow;
+class QPlainTextEdit;
+class TokenTableModel;
+
+/**
+ * @class LatencyBenchmark
+ * @brief 界面响应延迟的无头基准测试。
+ *
+ * 依次把不同大小的合成源码载入主窗口当前的文档，向编辑器发送按键事件模拟输入，
+ * 对每次按键记录：
+ * - 按键处理耗时：事件在界面线程上同步处理的时间；
+ * - 首批 Token 延迟：从按键到 Token 表收到第一块结果；
+ * - 完整 Token 表延迟：从按键到 Token 表换上完整的扫描结果（大文件包含重新编译前的延迟）。
+ * 同时用 1 毫秒的心跳定时器检测界面线程的停顿，超过一帧（16 毫秒）的间隔计入阻塞时间。
+ * 结果按文件大小输出 p50/p95/p99 与进程的峰值常驻内存。
+ *
+ * 通过 --benchmark 启动，未指定时使用 offscreen 平台插件，可在没有显示器的 Linux 上运行。
+ */
+class LatencyBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造基准测试。
+     * @param window 被测的主窗口，须已创建好第一个文档。
+     * @param arguments 命令行参数：--sizes 10000,100000 指定源码字符数，--edits N 指定每个大小的按键次数，
+     *        --budget MS 指定完整 Token 表延迟 p95 的上限。
+     */
+    LatencyBenchmark(MainWindow *window, const QStringList &arguments, QObject *parent = nullptr);
+
+    /**
+     * @brief 运行全部测试并输出结果。
+     * @return 进程退出码：全部完成且未超出上限时为 0。
+     */
+    int run();
+
+private:
+    /**
+     * @brief 一个源码大小的测量结果，单位均为毫秒。
+     */
+    struct Samples {
+        QVector<double> handling;   ///< 按键处理耗时。
+        QVector<double> firstChunk; ///< 首批 Token 延迟。
+        QVector<double> fullTable;  ///< 完整 Token 表延迟。
+        double blocked = 0;         ///< 界面线程停顿的总时长。
+        double maxStall = 0;        ///< 最长的一次停顿。
+        int timeouts = 0;           ///< 超时未等到完整结果的按键数。
+    };
+
+    /**
+     * @brief 生成约 chars 个字符、语法正确的合成源码。
+     */
+    static QString syntheticSource(int chars);
+
+    /**
+     * @brief 进入事件循环，等待 Token 表换上完整结果。
+     * @return 超时返回 false。
+     */
+    bool waitForScan(int timeoutMs);
+
+    /**
+     * @brief 测量一个源码大小。
+     */
+    Samples measure(int chars);
+
+    /**
+     * @brief 心跳定时器的回调，统计界面线程的停顿。
+     */
+    void heartbeat();
+
+    /**
+     * @brief 输出一个源码大小的结果。
+     */
+    void report(int chars, const Samples &samples) const;
+
+    /**
+     * @brief 计算百分位数，samples 为空时返回 0。
+     */
+    static double percentile(QVector<double> samples, double p);
+
+    /**
+     * @brief 返回进程的峰值常驻内存（KB），不支持的平台返回 -1。
+     */
+    static long peakRssKb();
+
+    static constexpr int STALL_MS = 16;          ///< 超过该间隔的心跳视为界面停顿。
+    static constexpr int SCAN_TIMEOUT_MS = 60000; ///< 等待一次完整结果的上限。
+
+    MainWindow *window;           ///< 被测窗口。
+    QPlainTextEdit *editor;       ///< 当前文档的编辑器。
+    TokenTableModel *model;       ///< 当前文档的 Token 表模型。
+    QVector<int> sizes;           ///< 要测试的源码字符数。
+    int edits;                    ///< 每个大小的按键次数。
+    double budget;                ///< 完整 Token 表延迟 p95 的上限，不大于 0 表示不检查。
+
+    QElapsedTimer clock;          ///< 测量用的单调时钟。
+    QTimer pulse;                 ///< 检测停顿的心跳定时器。
+    qint64 lastPulse;             ///< 上一次心跳的时刻。
+    qint64 editStart;             ///< 本次按键的时刻，-1 表示不在测量中。
+    double firstChunkMs;          ///< 本次按键的首批 Token 延迟，-1 表示尚未收到。
+    Samples *current;             ///< 正在记录的结果。
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,337 @@
+#include "dfascanner.h"
+#include "arena.h"
+#include <QDebug>
+#include <cstdint>
+
+namespace {
+
+// 字符类。CC_SLOW 只出现在字符类表中，表示需要走 Unicode 慢路径重新分类；
+// CC_EOF 是输入结束时的虚拟字符类。
+enum CharClass : std::uint8_t {
+    CC_OTHER,       // 非法字符
+    CC_SPACE,       // ' ' '\t' '\r'
+    CC_NEWLINE,     // '\n'
+    CC_DIGIT,       // 数字
+    CC_ALPHA,       // 字母和 '_'
+    CC_ALNUM,       // 非数字的 Unicode 数字类字符，只能出现在标识符中间
+    CC_DOT, CC_SLASH, CC_STAR,
+    CC_LESS, CC_GREATER, CC_EQUAL, CC_BANG,
+    CC_LPAREN, CC_RPAREN, CC_LBRACE, CC_RBRACE,
+    CC_COMMA, CC_COLON, CC_PLUS, CC_MINUS, CC_SEMI, CC_HASH,
+    CC_EOF,
+    CC_COUNT,
+    CC_SLOW = CC_COUNT
+};
+
+// DFA 状态。S_DEAD 为死状态，转移到它表示当前 Token 已结束。
+enum State : std::uint8_t {
+    S_DEAD,
+    S_START,
+    S_SPACE,
+    S_IDENT,
+    S_INT, S_INT_DOT, S_FRAC,
+    S_LESS, S_LESS_EQUAL,
+    S_GREATER, S_GREATER_EQUAL,
+    S_ASSIGN, S_EQUAL,
+    S_BANG, S_NOT_EQUAL,
+    S_SLASH, S_LINE_COMMENT,
+    S_BLOCK_OPEN, S_BLOCK_BODY, S_BLOCK_STAR, S_BLOCK_DONE, S_BLOCK_UNTERMINATED,
+    S_DOT, S_STAR,
+    S_LPAREN, S_RPAREN, S_LBRACE, S_RBRACE,
+    S_COMMA, S_COLON, S_PLUS, S_MINUS, S_SEMI, S_HASH,
+    S_BAD,
+    S_COUNT
+};
+
+// 接受状态的动作。A_NONE 表示非接受状态。
+enum Action : std::uint8_t {
+    A_NONE,
+    A_SKIP,          // 空白、注释，不产生 Token
+    A_TOKEN,         // 产生 DfaTable::type 中对应类型的 Token
+    A_IDENT,         // 标识符，需进一步查关键字表
+    A_BAD,           // 非法字符
+    A_UNTERMINATED   // 未闭合的多行注释
+};
+
+struct CharClassTable {
+    std::uint8_t cls[256];
+};
+
+struct DfaTable {
+    std::uint8_t next[S_COUNT][CC_COUNT];
+    std::uint8_t action[S_COUNT];
+    TokenType type[S_COUNT];
+};
+
+constexpr CharClassTable buildCharClasses() {
+    CharClassTable t{};
+    for (int c = 0; c < 256; ++c) {
+        t.cls[c] = c < 0x80 ? CC_OTHER : CC_SLOW;
+    }
+    for (int c = '0'; c <= '9'; ++c) t.cls[c] = CC_DIGIT;
+    for (int c = 'a'; c <= 'z'; ++c) t.cls[c] = CC_ALPHA;
+    for (int c = 'A'; c <= 'Z'; ++c) t.cls[c] = CC_ALPHA;
+    t.cls[static_cast<unsigned char>('_')] = CC_ALPHA;
+    t.cls[static_cast<unsigned char>(' ')] = CC_SPACE;
+    t.cls[static_cast<unsigned char>('\t')] = CC_SPACE;
+    t.cls[static_cast<unsigned char>('\r')] = CC_SPACE;
+    t.cls[static_cast<unsigned char>('\n')] = CC_NEWLINE;
+    t.cls[static_cast<unsigned char>('.')] = CC_DOT;
+    t.cls[static_cast<unsigned char>('/')] = CC_SLASH;
+    t.cls[static_cast<unsigned char>('*')] = CC_STAR;
+    t.cls[static_cast<unsigned char>('<')] = CC_LESS;
+    t.cls[static_cast<unsigned char>('>')] = CC_GREATER;
+    t.cls[static_cast<unsigned char>('=')] = CC_EQUAL;
+    t.cls[static_cast<unsigned char>('!')] = CC_BANG;
+    t.cls[static_cast<unsigned char>('(')] = CC_LPAREN;
+    t.cls[static_cast<unsigned char>(')')] = CC_RPAREN;
+    t.cls[static_cast<unsigned char>('{')] = CC_LBRACE;
+    t.cls[static_cast<unsigned char>('}')] = CC_RBRACE;
+    t.cls[static_cast<unsigned char>(',')] = CC_COMMA;
+    t.cls[static_cast<unsigned char>(':')] = CC_COLON;
+    t.cls[static_cast<unsigned char>('+')] = CC_PLUS;
+    t.cls[static_cast<unsigned char>('-')] = CC_MINUS;
+    t.cls[static_cast<unsigned char>(';')] = CC_SEMI;
+    t.cls[static_cast<unsigned char>('#')] = CC_HASH;
+    return t;
+}
+
+constexpr DfaTable buildDfa() {
+    DfaTable t{};
+    for (int s = 0; s < S_COUNT; ++s) {
+        for (int c = 0; c < CC_COUNT; ++c) t.next[s][c] = S_DEAD;
+        t.action[s] = A_NONE;
+        t.type[s] = TokenType::EOF_TOKEN;
+    }
+
+    // 起始状态：每个实际字符都能转移到某个接受状态，保证每轮至少消费一个字符
+    for (int c = 0; c < CC_EOF; ++c) t.next[S_START][c] = S_BAD;
+    t.next[S_START][CC_SPACE] = S_SPACE;
+    t.next[S_START][CC_NEWLINE] = S_SPACE;
+    t.next[S_START][CC_DIGIT] = S_INT;
+    t.next[S_START][CC_ALPHA] = S_IDENT;
+    t.next[S_START][CC_DOT] = S_DOT;
+    t.next[S_START][CC_SLASH] = S_SLASH;
+    t.next[S_START][CC_STAR] = S_STAR;
+    t.next[S_START][CC_LESS] = S_LESS;
+    t.next[S_START][CC_GREATER] = S_GREATER;
+    t.next[S_START][CC_EQUAL] = S_ASSIGN;
+    t.next[S_START][CC_BANG] = S_BANG;
+    t.next[S_START][CC_LPAREN] = S_LPAREN;
+    t.next[S_START][CC_RPAREN] = S_RPAREN;
+    t.next[S_START][CC_LBRACE] = S_LBRACE;
+    t.next[S_START][CC_RBRACE] = S_RBRACE;
+    t.next[S_START][CC_COMMA] = S_COMMA;
+    t.next[S_START][CC_COLON] = S_COLON;
+    t.next[S_START][CC_PLUS] = S_PLUS;
+    t.next[S_START][CC_MINUS] = S_MINUS;
+    t.next[S_START][CC_SEMI] = S_SEMI;
+    t.next[S_START][CC_HASH] = S_HASH;
+
+    // 空白
+    t.next[S_SPACE][CC_SPACE] = S_SPACE;
+    t.next[S_SPACE][CC_NEWLINE] = S_SPACE;
+    t.action[S_SPACE] = A_SKIP;
+
+    // 标识符 / 关键字
+    t.next[S_IDENT][CC_ALPHA] = S_IDENT;
+    t.next[S_IDENT][CC_DIGIT] = S_IDENT;
+    t.next[S_IDENT][CC_ALNUM] = S_IDENT;
+    t.action[S_IDENT] = A_IDENT;
+
+    // 数字：整数部分，'.' 后必须紧跟数字才进入小数部分，否则回退到整数
+    t.next[S_INT][CC_DIGIT] = S_INT;
+    t.next[S_INT][CC_DOT] = S_INT_DOT;
+    t.next[S_INT_DOT][CC_DIGIT] = S_FRAC;
+    t.next[S_FRAC][CC_DIGIT] = S_FRAC;
+    t.action[S_INT] = A_TOKEN;  t.type[S_INT] = TokenType::NUMBER;
+    t.action[S_FRAC] = A_TOKEN; t.type[S_FRAC] = TokenType::NUMBER;
+
+    // 双字符运算符
+    t.next[S_LESS][CC_EQUAL] = S_LESS_EQUAL;
+    t.next[S_GREATER][CC_EQUAL] = S_GREATER_EQUAL;
+    t.next[S_ASSIGN][CC_EQUAL] = S_EQUAL;
+    t.next[S_BANG][CC_EQUAL] = S_NOT_EQUAL;
+    t.action[S_LESS] = A_TOKEN;          t.type[S_LESS] = TokenType::LESS;
+    t.action[S_LESS_EQUAL] = A_TOKEN;    t.type[S_LESS_EQUAL] = TokenType::LESS_EQUAL;
+    t.action[S_GREATER] = A_TOKEN;       t.type[S_GREATER] = TokenType::GREATER;
+    t.action[S_GREATER_EQUAL] = A_TOKEN; t.type[S_GREATER_EQUAL] = TokenType::GREATER_EQUAL;
+    t.action[S_ASSIGN] = A_TOKEN;        t.type[S_ASSIGN] = TokenType::ASSIGNMENT;
+    t.action[S_EQUAL] = A_TOKEN;         t.type[S_EQUAL] = TokenType::EQUAL;
+    t.action[S_BANG] = A_TOKEN;          t.type[S_BANG] = TokenType::BANG;
+    t.action[S_NOT_EQUAL] = A_TOKEN;     t.type[S_NOT_EQUAL] = TokenType::NOT_EQUAL;
+
+    // 除号与注释
+    t.next[S_SLASH][CC_SLASH] = S_LINE_COMMENT;
+    t.next[S_SLASH][CC_STAR] = S_BLOCK_OPEN;
+    t.action[S_SLASH] = A_TOKEN; t.type[S_SLASH] = TokenType::DIVIDE;
+
+    // 单行注释：直到换行（不含换行）
+    for (int c = 0; c < CC_EOF; ++c) t.next[S_LINE_COMMENT][c] = S_LINE_COMMENT;
+    t.next[S_LINE_COMMENT][CC_NEWLINE] = S_DEAD;
+    t.action[S_LINE_COMMENT] = A_SKIP;
+
+    // 多行注释：与 Scanner::tryConsumeComment 一致，"/*" 之后的第一个字符
+    // 无条件跳过，不参与 "*/" 的匹配
+    for (int c = 0; c < CC_EOF; ++c) {
+        t.next[S_BLOCK_OPEN][c] = S_BLOCK_BODY;
+        t.next[S_BLOCK_BODY][c] = S_BLOCK_BODY;
+        t.next[S_BLOCK_STAR][c] = S_BLOCK_BODY;
+    }
+    t.next[S_BLOCK_BODY][CC_STAR] = S_BLOCK_STAR;
+    t.next[S_BLOCK_STAR][CC_STAR] = S_BLOCK_STAR;
+    t.next[S_BLOCK_STAR][CC_SLASH] = S_BLOCK_DONE;
+    t.next[S_BLOCK_OPEN][CC_EOF] = S_BLOCK_UNTERMINATED;
+    t.next[S_BLOCK_BODY][CC_EOF] = S_BLOCK_UNTERMINATED;
+    t.next[S_BLOCK_STAR][CC_EOF] = S_BLOCK_UNTERMINATED;
+    t.action[S_BLOCK_DONE] = A_SKIP;
+    t.action[S_BLOCK_UNTERMINATED] = A_UNTERMINATED;
+
+    // 单字符 Token
+    t.action[S_DOT] = A_TOKEN;    t.type[S_DOT] = TokenType::DOT;
+    t.action[S_STAR] = A_TOKEN;   t.type[S_STAR] = TokenType::MULTIPLY;
+    t.action[S_LPAREN] = A_TOKEN; t.type[S_LPAREN] = TokenType::LEFT_PAREN;
+    t.action[S_RPAREN] = A_TOKEN; t.type[S_RPAREN] = TokenType::RIGHT_PAREN;
+    t.action[S_LBRACE] = A_TOKEN; t.type[S_LBRACE] = TokenType::LEFT_BRACE;
+    t.action[S_RBRACE] = A_TOKEN; t.type[S_RBRACE] = TokenType::RIGHT_BRACE;
+    t.action[S_COMMA] = A_TOKEN;  t.type[S_COMMA] = TokenType::COMMA;
+    t.action[S_COLON] = A_TOKEN;  t.type[S_COLON] = TokenType::COLON;
+    t.action[S_PLUS] = A_TOKEN;   t.type[S_PLUS] = TokenType::PLUS;
+    t.action[S_MINUS] = A_TOKEN;  t.type[S_MINUS] = TokenType::MINUS;
+    t.action[S_SEMI] = A_TOKEN;   t.type[S_SEMI] = TokenType::SEMICOLON;
+    t.action[S_HASH] = A_TOKEN;   t.type[S_HASH] = TokenType::HASH;
+
+    t.action[S_BAD] = A_BAD;
+    return t;
+}
+
+constexpr CharClassTable kCharClasses = buildCharClasses();
+constexpr DfaTable kDfa = buildDfa();
+
+static_assert(sizeof(kDfa.next) <= 1024, "DFA 转移表应能常驻 L1 缓存");
+
+/**
+ * @brief 非 ASCII 字符的慢路径分类，判定规则与 Scanner 使用的 QChar 函数一致。
+ */
+std::uint8_t classifySlow(QChar c) {
+    if (c.isDigit()) return CC_DIGIT;
+    if (c.isLetter()) return CC_ALPHA;
+    if (c.isLetterOrNumber()) return CC_ALNUM;
+    return CC_OTHER;
+}
+
+} // namespace
+
+DfaScanner::DfaScanner(const QString& source)
+    : source(source), lineIndexBuilt(false), warningsEnabled(true) {}
+
+void DfaScanner::setWarningsEnabled(bool enabled) {
+    warningsEnabled = enabled;
+}
+
+QVector<Token> DfaScanner::scanTokens() {
+    const ushort* text = source.utf16();
+    const int length = source.size();
+    int pos = 0;
+    tokens.reserve(int(CompileArena::estimateTokens(length)));
+
+    while (pos < length) {
+        const int start = pos;
+        int state = S_START;
+        int acceptState = S_DEAD;
+        int acceptEnd = start;
+
+        // 最长匹配：一直转移到死状态，记录最后一个接受状态的位置
+        for (;;) {
+            std::uint8_t cls = CC_EOF;
+            if (pos < length) {
+                const ushort u = text[pos];
+                cls = u < 256 ? kCharClasses.cls[u] : static_cast<std::uint8_t>(CC_SLOW);
+                if (Q_UNLIKELY(cls == CC_SLOW)) cls = classifySlow(QChar(u));
+            }
+            const int next = kDfa.next[state][cls];
+            if (next == S_DEAD) break;
+            state = next;
+            if (cls == CC_EOF) {
+                acceptState = state;
+                acceptEnd = pos;
+                break;
+            }
+            ++pos;
+            if (kDfa.action[state] != A_NONE) {
+                acceptState = state;
+                acceptEnd = pos;
+            }
+        }
+        pos = acceptEnd;
+
+        switch (kDfa.action[acceptState]) {
+            case A_TOKEN: {
+                // 固定拼写的 Token 使用静态字符串，只有数字需要截取子串
+                const TokenType type = kDfa.type[acceptState];
+                QString value = tokenSpelling(type);
+                if (value.isEmpty()) value = source.mid(start, pos - start);
+                tokens.append(Token(type, value, start));
+                break;
+            }
+            case A_IDENT: {
+                QString value = source.mid(start, pos - start);
+                const TokenType type = lookupKeyword(value);
+                tokens.append(Token(type, type == TokenType::IDENTIFIER ? value : tokenSpelling(type), start));
+                if (value == "include") pos = headerName(pos);
+                break;
+            }
+            case A_BAD: {
+                if (!warningsEnabled) break;
+                SourceLocation loc = locate(start);
+                qWarning() << "Unexpected character '" << source[start] << "' at line" << loc.line
+                           << "column" << loc.column;
+                break;
+            }
+            case A_UNTERMINATED: {
+                if (!warningsEnabled) break;
+                SourceLocation loc = locate(start);
+                qWarning() << "Unterminated multi-line comment at line" << loc.line
+                           << "column" << loc.column;
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    tokens.append(Token(TokenType::EOF_TOKEN, "", length));
+    return tokens;
+}
+
+int DfaScanner::headerName(int pos) {
+    // 前一个 Token 必须是行首的 '#'
+    const int count = tokens.size();
+    if (count < 2 || tokens[count - 2].type != TokenType::HASH) return pos;
+    for (int i = tokens[count - 2].offset - 1; i >= 0 && source[i] != '\n'; --i) {
+        if (source[i] != ' ' && source[i] != '\t') return pos;
+    }
+
+    int begin = pos;
+    while (begin < source.size() && (source[begin] == ' ' || source[begin] == '\t')) ++begin;
+    if (begin >= source.size()) return pos;
+    QChar close;
+    if (source[begin] == '"') close = '"';
+    else if (source[begin] == '<') close = '>';
+    else return pos;
+
+    int end = begin + 1;
+    while (end < source.size() && source[end] != close && source[end] != '\n') ++end;
+    if (end >= source.size() || source[end] != close) return pos;
+
+    tokens.append(Token(TokenType::HEADER_NAME, source.mid(begin, end + 1 - begin), begin));
+    return end + 1;
+}
+
+SourceLocation DfaScanner::locate(int offset) {
+    if (!lineIndexBuilt) {
+        lineIndex = LineIndex(source);
+        lineIndexBuilt = true;
+    }
+    return lineIndex.locate(offset);
+}
@@ -0,0 +1,63 @@
+#ifndef DFASCANNER_H
+#define DFASCANNER_H
+
+#include <QString>
+#include <QVector>
+#include "token.h"
+#include "lineindex.h"
+
+/**
+ * @class DfaScanner
+ * @brief 表驱动的词法分析器，与 Scanner 产生完全相同的 Token 流。
+ *
+ * 字符先经 256 项字符类表映射为字符类，再查编译期生成的 DFA 状态转移表，
+ * 按最长匹配原则识别 Token。ASCII 字符只走查表路径；非 ASCII 字符走慢路径，
+ * 使用 QChar 的 Unicode 判定函数，保证与 Scanner 的识别结果一致。#include 之后的
+ * 头文件名依赖上下文，不在 DFA 中识别，而是在识别出 include 之后按与 Scanner 相同的
+ * 规则单独处理为 HEADER_NAME。两者的一致性由 --check-scanners 检查（见 ScannerCheck）。
+ *
+ * 用于一次扫描整个文件的场合（头文件缓存、--emit-ir）；编辑器的后台流水线需要分块
+ * 发布 Token 并记录注释范围，仍使用 Scanner。
+ */
+class DfaScanner {
+public:
+    /**
+     * @brief 构造函数，初始化 DfaScanner。
+     * @param source 输入的源代码字符串。
+     */
+    DfaScanner(const QString& source);
+
+    /**
+     * @brief 执行扫描操作，将源代码转换为 Token 列表。
+     * @return 包含所有 Token 的 QVector。
+     */
+    QVector<Token> scanTokens();
+
+    /**
+     * @brief 设置是否输出非法字符、未闭合注释等警告，默认输出。
+     */
+    void setWarningsEnabled(bool enabled);
+
+private:
+    /**
+     * @brief 识别紧跟在行首 "#include" 之后的头文件名，规则与 Scanner::headerName 相同。
+     * @param pos include 之后的位置。
+     * @return 识别出 HEADER_NAME 时返回其后的位置，否则原样返回 pos。
+     */
+    int headerName(int pos);
+
+    /**
+     * @brief 将偏移量换算为行列号，仅在报告错误时使用。
+     * @param offset 源代码中的偏移量。
+     * @return 对应的行列位置。
+     */
+    SourceLocation locate(int offset);
+
+    const QString source;  ///< 原始源代码字符串。
+    QVector<Token> tokens; ///< 存储扫描结果 Token 列表。
+    LineIndex lineIndex;   ///< 按需构建的行首索引，用于错误报告。
+    bool lineIndexBuilt;   ///< 行首索引是否已构建。
+    bool warningsEnabled;  ///< 是否输出警告。
+};
+
+#endif // DFASCANNER_H
@@ -0,0 +1,153 @@
+#include "diagnostics.h"
+#include "lineindex.h"
+#include <algorithm>
+
+static_assert(static_cast<int>(TokenType::EOF_TOKEN) < 64, "TokenTypeSet 使用 64 位位图");
+
+QString diagnosticMessage(DiagCode code) {
+    switch (code) {
+        case DiagCode::MISSING_DECL_IDENTIFIER:     return "变量或函数声明缺少标识符";
+        case DiagCode::PARAMETERS_UNSUPPORTED:      return "函数参数列表解析未实现";
+        case DiagCode::INVALID_FUNCTION_BODY:       return "函数体解析失败";
+        case DiagCode::INVALID_INITIALIZER:         return "变量初始化表达式无效";
+        case DiagCode::MISSING_DECL_SEMICOLON:      return "变量声明缺少分号";
+        case DiagCode::MISSING_RIGHT_BRACE:         return "缺少右花括号";
+        case DiagCode::IF_MISSING_LEFT_PAREN:       return "if语句缺少左括号";
+        case DiagCode::IF_MISSING_RIGHT_PAREN:      return "if语句缺少右括号";
+        case DiagCode::RETURN_MISSING_SEMICOLON:    return "return语句缺少分号";
+        case DiagCode::MISSING_STATEMENT_SEMICOLON: return "缺少语句结束的分号";
+        case DiagCode::INVALID_ASSIGNMENT_VALUE:    return "赋值表达式右侧无效";
+        case DiagCode::MISSING_RIGHT_PAREN:         return "缺少右括号";
+        case DiagCode::EXPECTED_PRIMARY:            return "预期数字、标识符或括号表达式";
+        case DiagCode::UNEXPECTED_TOKEN:            return "意外的Token";
+        case DiagCode::NESTING_TOO_DEEP:            return "嵌套层次过深";
+        case DiagCode::UNDECLARED_IDENTIFIER:       return "使用了未声明的标识符";
+        case DiagCode::REDECLARED_IDENTIFIER:       return "同一作用域中重复声明";
+        case DiagCode::FUNCTION_AS_VALUE:           return "函数名不能作为值使用";
+        case DiagCode::TYPE_MISMATCH:               return "类型不匹配：float 值不能隐式转换为 int 或 char";
+    }
+    return "未知错误";
+}
+
+bool isSemanticError(DiagCode code) {
+    return code >= DiagCode::UNDECLARED_IDENTIFIER;
+}
+
+TokenTypeSet::TokenTypeSet(std::initializer_list<TokenType> types) {
+    for (TokenType type : types) {
+        bits |= quint64(1) << static_cast<int>(type);
+    }
+}
+
+bool TokenTypeSet::contains(TokenType type) const {
+    return (bits >> static_cast<int>(type)) & 1;
+}
+
+void TokenTypeSet::insert(TokenType type) {
+    bits |= quint64(1) << static_cast<int>(type);
+}
+
+bool TokenTypeSet::isEmpty() const {
+    return bits == 0;
+}
+
+QVector<TokenType> TokenTypeSet::toList() const {
+    QVector<TokenType> types;
+    for (int i = 0; i <= static_cast<int>(TokenType::EOF_TOKEN); ++i) {
+        if ((bits >> i) & 1) types.append(static_cast<TokenType>(i));
+    }
+    return types;
+}
+
+DiagnosticBuffer::DiagnosticBuffer(int maxErrors)
+    : limit(std::max(1, maxErrors)), truncated(false) {
+    items.reserve(limit);
+}
+
+bool DiagnosticBuffer::report(DiagCode code, int tokenIndex, TokenTypeSet expected) {
+    if (items.size() >= limit) {
+        truncated = true;
+        return false;
+    }
+    items.append({code, tokenIndex, expected});
+    return true;
+}
+
+void DiagnosticBuffer::append(const DiagnosticBuffer& other) {
+    for (const Diagnostic& d : other.items) {
+        if (!report(d.code, d.tokenIndex, d.expected)) break;
+    }
+    truncated = truncated || other.truncated;
+}
+
+void DiagnosticBuffer::clear() {
+    items.clear();
+    truncated = false;
+}
+
+bool DiagnosticBuffer::isFull() const {
+    return items.size() >= limit;
+}
+
+bool DiagnosticBuffer::isTruncated() const {
+    return truncated;
+}
+
+int DiagnosticBuffer::maxErrors() const {
+    return limit;
+}
+
+int DiagnosticBuffer::size() const {
+    return items.size();
+}
+
+bool DiagnosticBuffer::isEmpty() const {
+    return items.isEmpty();
+}
+
+const Diagnostic& DiagnosticBuffer::at(int i) const {
+    return items[i];
+}
+
+QString DiagnosticBuffer::format(int i, const QVector<Token>& tokens, const LineIndex* lines) const {
+    const Diagnostic& d = items[i];
+    const Token& token = tokens[d.tokenIndex];
+
+    QString where;
+    if (lines) {
+        SourceLocation loc = lines->locate(token.offset);
+        where = QString("行 %1, 列 %2").arg(loc.line).arg(loc.column);
+    } else {
+        where = QString("偏移 %1").arg(token.offset);
+    }
+    QString message = QString("%1 [%2]: %3 (Token: %4)")
+                      .arg(isSemanticError(d.code) ? "语义错误" : "语法错误")
+                      .arg(where)
+                      .arg(diagnosticMessage(d.code))
+                      .arg(token.value.isEmpty() ? getTokenTypeString(token.type) : token.value);
+
+    if (!d.expected.isEmpty()) {
+        QStringList names;
+        for (TokenType type : d.expected.toList()) {
+            names.append(getTokenTypeString(type));
+        }
+        message += QString("，期望: %1").arg(names.join(", "));
+    }
+    return message;
+}
+
+QStringList DiagnosticBuffer::formatAll(const QVector<Token>& tokens, const LineIndex* lines) const {
+    return formatRange(0, items.size(), tokens, lines);
+}
+
+QStringList DiagnosticBuffer::formatRange(int first, int last, const QVector<Token>& tokens,
+                                          const LineIndex* lines) const {
+    QStringList messages;
+    for (int i = first; i < last; ++i) {
+        messages.append(format(i, tokens, lines));
+    }
+    if (truncated && last == items.size()) {
+        messages.append(QString("错误数量超过 %1 条，已停止分析").arg(limit));
+    }
+    return messages;
+}
@@ -0,0 +1,192 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+#include <initializer_list>
+#include "token.h"
+
+class LineIndex;
+
+/**
+ * @enum DiagCode
+ * @brief 语法错误与语义错误的种类，每种对应一条固定的错误描述。
+ */
+enum class DiagCode : quint8 {
+    MISSING_DECL_IDENTIFIER,      ///< 变量或函数声明缺少标识符
+    PARAMETERS_UNSUPPORTED,       ///< 函数参数列表解析未实现
+    INVALID_FUNCTION_BODY,        ///< 函数体解析失败
+    INVALID_INITIALIZER,          ///< 变量初始化表达式无效
+    MISSING_DECL_SEMICOLON,       ///< 变量声明缺少分号
+    MISSING_RIGHT_BRACE,          ///< 缺少右花括号
+    IF_MISSING_LEFT_PAREN,        ///< if语句缺少左括号
+    IF_MISSING_RIGHT_PAREN,       ///< if语句缺少右括号
+    RETURN_MISSING_SEMICOLON,     ///< return语句缺少分号
+    MISSING_STATEMENT_SEMICOLON,  ///< 缺少语句结束的分号
+    INVALID_ASSIGNMENT_VALUE,     ///< 赋值表达式右侧无效
+    MISSING_RIGHT_PAREN,          ///< 缺少右括号
+    EXPECTED_PRIMARY,             ///< 预期数字、标识符或括号表达式
+    UNEXPECTED_TOKEN,             ///< LALR 分析表中没有对应动作的 Token
+    NESTING_TOO_DEEP,             ///< 嵌套层次超过递归下降分析的上限
+
+    // 语义错误
+    UNDECLARED_IDENTIFIER,        ///< 使用了未声明的标识符
+    REDECLARED_IDENTIFIER,        ///< 同一作用域中重复声明
+    FUNCTION_AS_VALUE,            ///< 函数名被当作变量使用
+    TYPE_MISMATCH                 ///< 浮点值隐式转换为整型或字符型
+};
+
+/**
+ * @brief 返回错误种类对应的描述文本。
+ * @param code 错误种类。
+ * @return 错误描述。
+ */
+QString diagnosticMessage(DiagCode code);
+
+/**
+ * @brief 判断错误种类是否属于语义错误。
+ */
+bool isSemanticError(DiagCode code);
+
+/**
+ * @class TokenTypeSet
+ * @brief 以位图表示的 TokenType 集合，用于记录出错位置期望的 Token。
+ */
+class TokenTypeSet {
+public:
+    TokenTypeSet() = default;
+
+    /**
+     * @brief 由若干 TokenType 构造集合。
+     */
+    TokenTypeSet(std::initializer_list<TokenType> types);
+
+    /**
+     * @brief 判断集合中是否包含指定类型。
+     */
+    bool contains(TokenType type) const;
+
+    /**
+     * @brief 向集合中加入一个类型。
+     */
+    void insert(TokenType type);
+
+    /**
+     * @brief 判断集合是否为空。
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief 按枚举顺序返回集合中的所有类型。
+     */
+    QVector<TokenType> toList() const;
+
+private:
+    quint64 bits = 0; ///< 第 i 位表示第 i 个 TokenType。
+};
+
+/**
+ * @struct Diagnostic
+ * @brief 一条结构化的语法错误记录，文本只在需要显示时才生成。
+ */
+struct Diagnostic {
+    DiagCode code;         ///< 错误种类。
+    int tokenIndex;        ///< 出错 Token 在 Token 序列中的下标。
+    TokenTypeSet expected; ///< 出错位置期望的 Token 类型，可为空。
+};
+
+/**
+ * @class DiagnosticBuffer
+ * @brief 预分配的错误记录缓冲区，记录数量达到上限后不再接收新错误。
+ *
+ * 语法分析过程中只追加定长记录，不做任何字符串格式化；调用方在需要显示时
+ * 再通过 format() 生成错误文本。
+ */
+class DiagnosticBuffer {
+public:
+    /**
+     * @brief 构造缓冲区并预留空间。
+     * @param maxErrors 最多记录的错误条数。
+     */
+    explicit DiagnosticBuffer(int maxErrors = 100);
+
+    /**
+     * @brief 记录一条错误。
+     * @param code 错误种类。
+     * @param tokenIndex 出错 Token 的下标。
+     * @param expected 期望的 Token 类型。
+     * @return 缓冲区未满返回 true；已满时丢弃该错误并返回 false。
+     */
+    bool report(DiagCode code, int tokenIndex, TokenTypeSet expected = TokenTypeSet());
+
+    /**
+     * @brief 将另一个缓冲区的记录按顺序追加到本缓冲区，超出上限的部分丢弃。
+     */
+    void append(const DiagnosticBuffer& other);
+
+    /**
+     * @brief 清空所有记录，保留已分配的空间。
+     */
+    void clear();
+
+    /**
+     * @brief 判断记录数量是否已达到上限。
+     */
+    bool isFull() const;
+
+    /**
+     * @brief 判断是否有错误因超出上限而被丢弃。
+     */
+    bool isTruncated() const;
+
+    /**
+     * @brief 返回最多记录的错误条数。
+     */
+    int maxErrors() const;
+
+    /**
+     * @brief 返回已记录的错误条数。
+     */
+    int size() const;
+
+    /**
+     * @brief 判断缓冲区是否为空。
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief 返回第 i 条错误记录。
+     */
+    const Diagnostic& at(int i) const;
+
+    /**
+     * @brief 生成第 i 条错误的文本。
+     * @param i 错误记录下标。
+     * @param tokens 产生这些错误的 Token 序列。
+     * @param lines 源代码的行首索引；为空时只报告偏移量。
+     * @return 格式化后的错误信息。
+     */
+    QString format(int i, const QVector<Token>& tokens, const LineIndex* lines) const;
+
+    /**
+     * @brief 生成全部错误的文本；有错误被丢弃时末尾追加一条提示。
+     */
+    QStringList formatAll(const QVector<Token>& tokens, const LineIndex* lines) const;
+
+    /**
+     * @brief 生成下标在 [first, last) 内的错误文本，供分块发布使用。
+     *
+     * last 到达末尾且有错误被丢弃时，末尾追加与 formatAll() 相同的提示。
+     */
+    QStringList formatRange(int first, int last, const QVector<Token>& tokens,
+                            const LineIndex* lines) const;
+
+private:
+    QVector<Diagnostic> items; ///< 错误记录。
+    int limit;                 ///< 最多记录的错误条数。
+    bool truncated;            ///< 是否有错误被丢弃。
+};
+
+#endif // DIAGNOSTICS_H
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <QTextBlock>
+#include <QTextDocument>
+
+#include "highlighter.h"
+#include "scanner.h"
+
+CodeHighlighter::CodeHighlighter(QTextDocument *parent)
+    : QSyntaxHighlighter(parent)
+    , sharedRevision(-1)
+    , deferred(false)
+    , hasPending(false)
+    , rehighlightNext(0)
+    , rehighlightRevision(-1)
+    , rehighlightScheduled(false)
+{
+    keywordFormat.setForeground(Qt::darkBlue);
+    keywordFormat.setFontWeight(QFont::Bold);
+    numberFormat.setForeground(Qt::darkMagenta);
+    operatorFormat.setForeground(Qt::darkRed);
+    commentFormat.setForeground(Qt::darkGreen);
+    commentFormat.setFontItalic(true);
+}
+
+void CodeHighlighter::setSharedTokens(const ScanResult &scan, int revision)
+{
+    shared = scan;
+    sharedRevision = revision;
+    if (hasFreshSharedTokens()) rehighlightPending();
+}
+
+void CodeHighlighter::setDeferred(bool deferred)
+{
+    this->deferred = deferred;
+    if (!deferred) rehighlightPending();
+}
+
+void CodeHighlighter::rehighlightPending()
+{
+    if (rehighlightScheduled || !hasPending) return;
+    rehighlightScheduled = true;
+    QMetaObject::invokeMethod(this, [this]() { rehighlightBatch(); }, Qt::QueuedConnection);
+}
+
+void CodeHighlighter::rehighlightBatch()
+{
+    rehighlightScheduled = false;
+    // 等待期间文档又被修改且仍处于延迟模式：留待下一次扫描结果到达
+    if (deferred && !hasFreshSharedTokens()) return;
+
+    // 按块的顺序处理，状态变化得以向后传递
+    if (document()->revision() != rehighlightRevision) rehighlightNext = 0;
+    QTextBlock block = document()->findBlockByNumber(rehighlightNext);
+    int highlighted = 0;
+    for (int visited = 0; block.isValid() && highlighted < REHIGHLIGHT_BATCH && visited < REHIGHLIGHT_SCAN;
+         ++visited) {
+        if (block.userData() != nullptr) {
+            rehighlightBlock(block);
+            ++highlighted;
+        }
+        block = block.next();
+    }
+    rehighlightRevision = document()->revision();
+    if (block.isValid()) {
+        rehighlightNext = block.blockNumber();
+    } else {
+        rehighlightNext = 0;
+        hasPending = false;
+    }
+    rehighlightPending();
+}
+
+void CodeHighlighter::highlightBlock(const QString &text)
+{
+    if (deferred && !hasFreshSharedTokens()) {
+        // 入口状态原样向后传递，等后台扫描结果到达后再高亮
+        setCurrentBlockState(previousBlockState());
+        if (currentBlockUserData() == nullptr) setCurrentBlockUserData(new PendingMark);
+        hasPending = true;
+        return;
+    }
+    if (currentBlockUserData() != nullptr) setCurrentBlockUserData(nullptr);
+    if (hasFreshSharedTokens()) {
+        highlightFromShared(text);
+        return;
+    }
+    highlightByScanning(text);
+}
+
+bool CodeHighlighter::hasFreshSharedTokens() const
+{
+    return sharedRevision >= 0 && document() && sharedRevision == document()->revision();
+}
+
+void CodeHighlighter::highlightFromShared(const QString &text)
+{
+    const int blockStart = currentBlock().position();
+    const int blockEnd = blockStart + text.length();
+
+    // Token 按偏移量有序，二分查找本块的第一个 Token
+    const QVector<Token> &tokens = shared.tokens;
+    auto token = std::lower_bound(tokens.begin(), tokens.end(), blockStart,
+                                  [](const Token &t, int offset) { return t.offset < offset; });
+    for (; token != tokens.end() && token->offset < blockEnd; ++token) {
+        if (token->type == TokenType::EOF_TOKEN) break;
+        formatToken(token->offset - blockStart, token->value.size(), token->type);
+    }
+
+    // 注释可能从前面的块延续过来，先退回到起点不晚于本块的最后一段注释
+    const QVector<CommentRange> &comments = shared.comments;
+    auto comment = std::upper_bound(comments.begin(), comments.end(), blockStart,
+                                    [](int offset, const CommentRange &c) { return offset < c.offset; });
+    if (comment != comments.begin()) --comment;
+
+    bool inComment = false;
+    for (; comment != comments.end() && comment->offset < blockEnd; ++comment) {
+        const int from = std::max(comment->offset, blockStart);
+        const int to = std::min(comment->offset + comment->length, blockEnd);
+        if (to > from) setFormat(from - blockStart, to - from, commentFormat);
+        if (comment->offset + comment->length > blockEnd) inComment = true;
+    }
+    setCurrentBlockState(inComment ? IN_COMMENT : 0);
+}
+
+void CodeHighlighter::highlightByScanning(const QString &text)
+{
+    Scanner scanner(text);
+    scanner.setRecordComments(true);
+    scanner.setWarningsEnabled(false);
+    scanner.setStartsInComment(previousBlockState() == IN_COMMENT);
+
+    for (const Token &token : scanner.scanTokens()) {
+        if (token.type == TokenType::EOF_TOKEN) break;
+        formatToken(token.offset, token.value.size(), token.type);
+    }
+    for (const CommentRange &comment : scanner.comments()) {
+        setFormat(comment.offset, comment.length, commentFormat);
+    }
+    setCurrentBlockState(scanner.endsInComment() ? IN_COMMENT : 0);
+}
+
+void CodeHighlighter::formatToken(int start, int length, TokenType type)
+{
+    if (type >= TokenType::AUTO && type <= TokenType::_IMAGINARY) {
+        setFormat(start, length, keywordFormat);
+    } else if (type == TokenType::NUMBER || type == TokenType::HEADER_NAME) {
+        setFormat(start, length, numberFormat);
+    } else if (type < TokenType::NUMBER) {
+        // 枚举中 NUMBER 之前均为运算符与分隔符
+        setFormat(start, length, operatorFormat);
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef HIGHLIGHTER_H
+#define HIGHLIGHTER_H
+
+#include <QSyntaxHighlighter>
+#include <QTextCharFormat>
+#include "pipeline.h"
+
+/**
+ * @class CodeHighlighter
+ * @brief 基于本项目 Scanner 的增量语法高亮器。
+ *
+ * 每个文本块保存块末的词法状态（是否处于未闭合的多行注释中）。编辑时 Qt 只重新
+ * 高亮被修改的块，以及入口状态因此改变的后续块；每块只扫描自身的一行文本。
+ *
+ * 后台流水线扫描完成后，其 Token 与注释范围通过 setSharedTokens() 交给高亮器；
+ * 只要文档自那次扫描后未被修改，高亮就直接查用这份结果，不再重复扫描。
+ * 延迟模式下跳过的块按批补上高亮，每批之间回到事件循环，大文件也不会阻塞界面。
+ */
+class CodeHighlighter : public QSyntaxHighlighter
+{
+    Q_OBJECT
+
+public:
+    explicit CodeHighlighter(QTextDocument *parent);
+
+    /**
+     * @brief 设置后台流水线对整个文档的扫描结果。
+     * @param scan 扫描结果，需包含注释范围。
+     * @param revision 扫描时文档的修订号（QTextDocument::revision()）。
+     */
+    void setSharedTokens(const ScanResult &scan, int revision);
+
+    /**
+     * @brief 设置延迟模式，用于大文件。
+     *
+     * 开启后，没有可用共享结果的块暂不在界面线程上扫描，等后台扫描结果到达后再补上高亮。
+     */
+    void setDeferred(bool deferred);
+
+protected:
+    void highlightBlock(const QString &text) override;
+
+private:
+    /**
+     * @brief 块末处于多行注释中时的块状态。
+     */
+    static constexpr int IN_COMMENT = 1;
+
+    /**
+     * @brief 每批补上高亮的块数。
+     */
+    static constexpr int REHIGHLIGHT_BATCH = 2000;
+
+    /**
+     * @brief 每批最多查看的块数，没有待补的块时也不会一次遍历整个大文件。
+     */
+    static constexpr int REHIGHLIGHT_SCAN = 50000;
+
+    /**
+     * @brief 延迟模式下跳过的块所带的标记。
+     *
+     * 标记挂在块上，随块一起移动，行号因编辑而变化时仍能找到原来的块。它不占用块
+     * 状态，去掉标记不会让 Qt 连带重新高亮后续的块。
+     */
+    class PendingMark : public QTextBlockUserData
+    {
+    };
+
+    /**
+     * @brief 安排重新高亮延迟模式下跳过的块。
+     */
+    void rehighlightPending();
+
+    /**
+     * @brief 从上一批停下的块起查找带标记的块并重新高亮，还有剩余时安排下一批。
+     *
+     * 两批之间文档被修改过时块号可能已移动，从第一个块重新查找。
+     */
+    void rehighlightBatch();
+
+    /**
+     * @brief 判断共享的扫描结果是否与当前文档一致。
+     */
+    bool hasFreshSharedTokens() const;
+
+    /**
+     * @brief 按共享的扫描结果高亮当前块。
+     */
+    void highlightFromShared(const QString &text);
+
+    /**
+     * @brief 扫描当前块的文本并高亮。
+     */
+    void highlightByScanning(const QString &text);
+
+    /**
+     * @brief 按 Token 类型设置一段文本的格式。
+     */
+    void formatToken(int start, int length, TokenType type);
+
+    QTextCharFormat keywordFormat;  ///< 关键字格式。
+    QTextCharFormat numberFormat;   ///< 数字格式。
+    QTextCharFormat operatorFormat; ///< 运算符与分隔符格式。
+    QTextCharFormat commentFormat;  ///< 注释格式。
+
+    ScanResult shared;              ///< 后台流水线的扫描结果。
+    int sharedRevision;             ///< shared 对应的文档修订号，-1 表示无。
+    bool deferred;                  ///< 是否处于延迟模式。
+    bool hasPending;                ///< 是否可能还有带 PendingMark 的块。
+    int rehighlightNext;            ///< 下一批开始查找的块号。
+    int rehighlightRevision;        ///< 上一批结束时的文档修订号。
+    bool rehighlightScheduled;      ///< 是否已安排了下一批。
+};
+
+#endif // HIGHLIGHTER_H
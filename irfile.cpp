@@ -0,0 +1,473 @@
+#include "irfile.h"
+#include <QtEndian>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#endif
+
+namespace {
+
+constexpr char MAGIC[4] = {'C', 'P', 'I', 'R'};
+constexpr quint16 VERSION_MAJOR = 1;
+constexpr quint16 VERSION_MINOR = 0;
+constexpr int FILE_HEADER_SIZE = 16;
+constexpr int BLOCK_HEADER_SIZE = 16;
+#ifdef Q_OS_UNIX
+constexpr int MAX_IOVECS = IOV_MAX < 64 ? IOV_MAX : 64; // 每次 writev() 最多的缓冲区数
+#endif
+
+// 记录区与文本区之后补零，使下一个块头按 8 字节对齐
+constexpr quint32 padding(quint64 bytes) {
+    return quint32((8 - bytes % 8) % 8);
+}
+
+template <typename T>
+void putLittleEndian(QByteArray& out, T value) {
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+QByteArray blockHeader(IrBlockKind kind, quint16 stride, quint32 count, quint32 textBytes, quint32 first) {
+    QByteArray header;
+    header.reserve(BLOCK_HEADER_SIZE);
+    putLittleEndian(header, static_cast<quint16>(kind));
+    putLittleEndian(header, stride);
+    putLittleEndian(header, count);
+    putLittleEndian(header, textBytes);
+    putLittleEndian(header, first);
+    return header;
+}
+
+// 按 JSON 字符串的规则转义，结果带引号
+void appendJsonString(QByteArray& out, const QString& text) {
+    static const char HEX[] = "0123456789abcdef";
+    out.append('"');
+    for (const char c : text.toUtf8()) {
+        switch (c) {
+            case '"':  out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                if (static_cast<uchar>(c) < 0x20) {
+                    out.append("\\u00");
+                    out.append(HEX[c >> 4]);
+                    out.append(HEX[c & 0xF]);
+                } else {
+                    out.append(c);
+                }
+                break;
+        }
+    }
+    out.append('"');
+}
+
+void appendJsonOperand(QByteArray& out, const Operand& operand) {
+    switch (operand.kind) {
+        case OperandKind::NAME:
+            out.append("{\"name\":");
+            appendJsonString(out, operand.text);
+            out.append('}');
+            return;
+        case OperandKind::CONST:
+            out.append("{\"const\":");
+            appendJsonString(out, operand.text);
+            out.append('}');
+            return;
+        case OperandKind::TEMP:
+            out.append("{\"temp\":").append(QByteArray::number(operand.id)).append('}');
+            return;
+        case OperandKind::LABEL:
+            out.append("{\"label\":").append(QByteArray::number(operand.id)).append('}');
+            return;
+        case OperandKind::NONE:
+            break;
+    }
+    out.append("null");
+}
+
+} // namespace
+
+IrWriter::IrWriter(Format format)
+    : format(format), failed(false), blockKind(IrBlockKind::END), blockFirst(0), blockCount(0),
+      queuedBytes(0), tokenCount(0), quadCount(0) {}
+
+IrWriter::~IrWriter() {
+    if (file.isOpen()) close();
+}
+
+bool IrWriter::open(const QString& path) {
+    failed = false;
+    error.clear();
+    tokenCount = quadCount = 0;
+    // 不经过 QFile 自己的缓冲：数据已经在块缓冲区里攒好，由 flush() 直接交给系统调用
+    bool opened;
+    if (path == "-") {
+        opened = file.open(1, QIODevice::WriteOnly | QIODevice::Unbuffered);
+    } else {
+        file.setFileName(path);
+        opened = file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered);
+    }
+    if (!opened) {
+        failed = true;
+        error = file.errorString();
+        return false;
+    }
+
+    QByteArray header;
+    if (format == Format::Binary) {
+        header.append(MAGIC, sizeof(MAGIC));
+        putLittleEndian(header, VERSION_MAJOR);
+        putLittleEndian(header, VERSION_MINOR);
+        putLittleEndian(header, quint32(0));
+        putLittleEndian(header, quint32(0));
+    } else {
+        header = QByteArray("{\"format\":\"cpir\",\"version\":") + QByteArray::number(VERSION_MAJOR) + "}\n";
+    }
+    queuedBytes += header.size();
+    queue.append(std::move(header));
+    return true;
+}
+
+void IrWriter::writeToken(const Token& token) {
+    if (format == Format::JsonLines) {
+        QByteArray line = "{\"token\":" + QByteArray::number(tokenCount++) + ",\"type\":\"";
+        line.append(getTokenTypeString(token.type).toLatin1()).append("\",\"text\":");
+        appendJsonString(line, token.value);
+        line.append(",\"offset\":").append(QByteArray::number(token.offset)).append("}\n");
+        appendLine(line);
+        return;
+    }
+
+    beginRecord(IrBlockKind::TOKENS);
+    IrTokenRecord record = {};
+    record.type = static_cast<quint8>(token.type);
+    record.offset = qToLittleEndian(quint32(token.offset));
+    // 运算符、关键字等固定拼写的 Token 不占文本区
+    quint32 length = 0;
+    const quint32 text = token.value == tokenSpelling(token.type) ? 0 : appendText(token.value, length);
+    record.text = qToLittleEndian(text);
+    record.length = qToLittleEndian(length);
+    records.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    ++blockCount;
+    ++tokenCount;
+}
+
+void IrWriter::writeTokens(const QVector<Token>& tokens, qsizetype first, qsizetype count) {
+    const qsizetype last = count < 0 ? tokens.size() : std::min(tokens.size(), first + count);
+    for (qsizetype i = first; i < last; ++i) writeToken(tokens[i]);
+}
+
+void IrWriter::writeQuad(const Quad& quad) {
+    if (format == Format::JsonLines) {
+        QByteArray line = "{\"quad\":" + QByteArray::number(quadCount++) + ",\"op\":";
+        appendJsonString(line, getQuadOpString(quad.op));
+        line.append(",\"arg1\":");
+        appendJsonOperand(line, quad.arg1);
+        line.append(",\"arg2\":");
+        appendJsonOperand(line, quad.arg2);
+        line.append(",\"result\":");
+        appendJsonOperand(line, quad.result);
+        line.append("}\n");
+        appendLine(line);
+        return;
+    }
+
+    beginRecord(IrBlockKind::QUADS);
+    IrQuadRecord record = {};
+    record.op = static_cast<quint8>(quad.op);
+    record.arg1 = encodeOperand(quad.arg1);
+    record.arg2 = encodeOperand(quad.arg2);
+    record.result = encodeOperand(quad.result);
+    records.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    ++blockCount;
+    ++quadCount;
+}
+
+void IrWriter::writeQuads(const QVector<Quad>& quads) {
+    for (const Quad& quad : quads) writeQuad(quad);
+}
+
+bool IrWriter::close() {
+    if (!file.isOpen()) return !failed;
+    if (format == Format::Binary) {
+        sealBlock();
+        QByteArray end = blockHeader(IrBlockKind::END, 0, 0, 0, 0);
+        queuedBytes += end.size();
+        queue.append(std::move(end));
+    } else if (!records.isEmpty()) {
+        queuedBytes += records.size();
+        queue.append(std::move(records));
+        records = QByteArray();
+    }
+    flush();
+    file.close();
+    return !failed;
+}
+
+QString IrWriter::errorString() const {
+    return error;
+}
+
+void IrWriter::beginRecord(IrBlockKind kind) {
+    if (blockKind == kind && blockCount < quint32(BLOCK_RECORDS)) return;
+    sealBlock();
+    blockKind = kind;
+    blockFirst = quint32(kind == IrBlockKind::TOKENS ? tokenCount : quadCount);
+    const int stride = kind == IrBlockKind::TOKENS ? sizeof(IrTokenRecord) : sizeof(IrQuadRecord);
+    records.reserve(BLOCK_RECORDS * stride);
+}
+
+quint32 IrWriter::appendText(const QString& value, quint32& length) {
+    const quint32 offset = quint32(text.size());
+    const QByteArray bytes = value.toUtf8();
+    text.append(bytes);
+    length = quint32(bytes.size());
+    return offset;
+}
+
+IrOperandRecord IrWriter::encodeOperand(const Operand& operand) {
+    IrOperandRecord record = {};
+    record.kind = static_cast<quint8>(operand.kind);
+    record.id = qToLittleEndian(qint32(operand.id));
+    if (operand.kind == OperandKind::NAME || operand.kind == OperandKind::CONST) {
+        quint32 length = 0;
+        record.text = qToLittleEndian(appendText(operand.text, length));
+        record.length = qToLittleEndian(length);
+    }
+    return record;
+}
+
+void IrWriter::sealBlock() {
+    if (blockKind == IrBlockKind::END) return;
+    const quint16 stride = blockKind == IrBlockKind::TOKENS ? sizeof(IrTokenRecord) : sizeof(IrQuadRecord);
+    const quint32 textBytes = quint32(text.size());
+    text.append(QByteArray(padding(quint64(records.size()) + textBytes), '\0'));
+
+    QByteArray header = blockHeader(blockKind, stride, blockCount, textBytes, blockFirst);
+    queuedBytes += header.size() + records.size() + text.size();
+    queue.append(std::move(header));
+    queue.append(std::move(records));
+    queue.append(std::move(text));
+    records = QByteArray();
+    text = QByteArray();
+    blockKind = IrBlockKind::END;
+    blockCount = 0;
+
+    if (queuedBytes >= FLUSH_BYTES) flush();
+}
+
+void IrWriter::appendLine(const QByteArray& line) {
+    records.append(line);
+    if (records.size() < FLUSH_BYTES) return;
+    queuedBytes += records.size();
+    queue.append(std::move(records));
+    records = QByteArray();
+    flush();
+}
+
+bool IrWriter::flush() {
+    if (queue.isEmpty()) return !failed;
+    if (!failed) {
+#ifdef Q_OS_UNIX
+        // 一次系统调用写出多个缓冲区；部分写入时跳过已写出的字节继续
+        const int fd = file.handle();
+        qsizetype next = 0;
+        qint64 skip = 0;
+        while (next < queue.size()) {
+            iovec parts[MAX_IOVECS];
+            int count = 0;
+            for (qsizetype i = next; i < queue.size() && count < MAX_IOVECS; ++i) {
+                const QByteArray& buffer = queue[i];
+                const qint64 offset = i == next ? skip : 0;
+                if (buffer.size() - offset <= 0) continue;
+                parts[count].iov_base = const_cast<char*>(buffer.constData()) + offset;
+                parts[count].iov_len = size_t(buffer.size() - offset);
+                ++count;
+            }
+            if (count == 0) break;
+            qint64 written = ::writev(fd, parts, count);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                failed = true;
+                error = QString::fromLocal8Bit(std::strerror(errno));
+                break;
+            }
+            // 按写出的字节数推进到下一个未写完的缓冲区
+            while (next < queue.size() && written >= queue[next].size() - skip) {
+                written -= queue[next].size() - skip;
+                skip = 0;
+                ++next;
+            }
+            skip += written;
+        }
+#else
+        for (const QByteArray& buffer : queue) {
+            if (file.write(buffer) != buffer.size()) {
+                failed = true;
+                error = file.errorString();
+                break;
+            }
+        }
+#endif
+    }
+    queue.clear();
+    queuedBytes = 0;
+    return !failed;
+}
+
+IrReader::IrReader() : data(nullptr), size(0), minor(0), complete(false) {}
+
+IrReader::~IrReader() {
+    close();
+}
+
+bool IrReader::open(const QString& path) {
+    close();
+    error.clear();
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) return fail(file.errorString());
+    size = file.size();
+    data = size > 0 ? file.map(0, size) : nullptr;
+    if (data == nullptr) return fail(QStringLiteral("无法映射文件"));
+
+    if (size < FILE_HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        return fail(QStringLiteral("不是 .cpir 文件"));
+    }
+    const quint16 major = qFromLittleEndian<quint16>(data + 4);
+    if (major != VERSION_MAJOR) {
+        return fail(QString("不支持的版本 %1（支持 %2）").arg(major).arg(VERSION_MAJOR));
+    }
+    minor = qFromLittleEndian<quint16>(data + 6);
+
+    // 只读块头建立索引；越界或记录过短的块视为文件损坏，之前的块仍然可用
+    qint64 at = FILE_HEADER_SIZE;
+    while (at + BLOCK_HEADER_SIZE <= size) {
+        const uchar *header = data + at;
+        const auto kind = static_cast<IrBlockKind>(qFromLittleEndian<quint16>(header));
+        if (kind == IrBlockKind::END) {
+            complete = true;
+            break;
+        }
+        Block block;
+        block.stride = qFromLittleEndian<quint16>(header + 2);
+        block.count = qFromLittleEndian<quint32>(header + 4);
+        block.textBytes = qFromLittleEndian<quint32>(header + 8);
+        block.first = qFromLittleEndian<quint32>(header + 12);
+        const quint64 recordBytes = quint64(block.stride) * block.count;
+        const quint64 bodyBytes = recordBytes + block.textBytes;
+        if (quint64(size - at - BLOCK_HEADER_SIZE) < bodyBytes + padding(bodyBytes)) break;
+        block.records = header + BLOCK_HEADER_SIZE;
+        block.text = block.records + recordBytes;
+        at += BLOCK_HEADER_SIZE + qint64(bodyBytes + padding(bodyBytes));
+
+        // 未知种类的块来自更新的次版本，跳过
+        QVector<Block> *blocks = kind == IrBlockKind::TOKENS ? &tokenBlocks
+                               : kind == IrBlockKind::QUADS  ? &quadBlocks
+                                                             : nullptr;
+        if (blocks == nullptr) continue;
+        const quint16 minimum = kind == IrBlockKind::TOKENS ? sizeof(IrTokenRecord) : sizeof(IrQuadRecord);
+        const quint64 expected = blocks->isEmpty() ? 0 : quint64(blocks->last().first) + blocks->last().count;
+        if (block.stride < minimum || block.first != expected) break;
+        blocks->append(block);
+    }
+    return true;
+}
+
+void IrReader::close() {
+    if (data != nullptr) file.unmap(const_cast<uchar*>(data));
+    if (file.isOpen()) file.close();
+    data = nullptr;
+    size = 0;
+    tokenBlocks.clear();
+    quadBlocks.clear();
+    minor = 0;
+    complete = false;
+}
+
+QString IrReader::errorString() const {
+    return error;
+}
+
+bool IrReader::isComplete() const {
+    return complete;
+}
+
+int IrReader::minorVersion() const {
+    return minor;
+}
+
+qsizetype IrReader::tokenCount() const {
+    return tokenBlocks.isEmpty() ? 0 : qsizetype(tokenBlocks.last().first) + tokenBlocks.last().count;
+}
+
+Token IrReader::token(qsizetype i) const {
+    const Block *block = nullptr;
+    const uchar *record = locate(tokenBlocks, i, &block);
+    if (record == nullptr) return Token(TokenType::EOF_TOKEN, QString(), 0);
+
+    const auto type = static_cast<TokenType>(record[0]);
+    const quint32 length = qFromLittleEndian<quint32>(record + 12);
+    const QString value = length == 0 ? tokenSpelling(type)
+                                      : textAt(*block, qFromLittleEndian<quint32>(record + 8), length);
+    return Token(type, value, int(qFromLittleEndian<quint32>(record + 4)));
+}
+
+qsizetype IrReader::quadCount() const {
+    return quadBlocks.isEmpty() ? 0 : qsizetype(quadBlocks.last().first) + quadBlocks.last().count;
+}
+
+Quad IrReader::quad(qsizetype i) const {
+    const Block *block = nullptr;
+    const uchar *record = locate(quadBlocks, i, &block);
+    Quad q{QuadOp::ASSIGN, Operand(), Operand(), Operand()};
+    if (record == nullptr) return q;
+
+    q.op = static_cast<QuadOp>(record[0]);
+    q.arg1 = decodeOperand(record + offsetof(IrQuadRecord, arg1), *block);
+    q.arg2 = decodeOperand(record + offsetof(IrQuadRecord, arg2), *block);
+    q.result = decodeOperand(record + offsetof(IrQuadRecord, result), *block);
+    return q;
+}
+
+const uchar *IrReader::locate(const QVector<Block>& blocks, qsizetype i, const Block **block) const {
+    if (i < 0 || blocks.isEmpty()) return nullptr;
+    // 第一个起始序号大于 i 的块的前一块
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), i,
+                               [](qsizetype index, const Block& b) { return index < qsizetype(b.first); });
+    if (it == blocks.begin()) return nullptr;
+    --it;
+    const qsizetype within = i - it->first;
+    if (within >= qsizetype(it->count)) return nullptr;
+    *block = &*it;
+    return it->records + within * it->stride;
+}
+
+Operand IrReader::decodeOperand(const uchar *record, const Block& block) {
+    Operand operand;
+    operand.kind = static_cast<OperandKind>(record[0]);
+    operand.id = qFromLittleEndian<qint32>(record + 4);
+    if (operand.kind == OperandKind::NAME || operand.kind == OperandKind::CONST) {
+        operand.text = textAt(block, qFromLittleEndian<quint32>(record + 8),
+                              qFromLittleEndian<quint32>(record + 12));
+    }
+    return operand;
+}
+
+QString IrReader::textAt(const Block& block, quint32 offset, quint32 length) {
+    if (quint64(offset) + length > block.textBytes) return QString();
+    return QString::fromUtf8(reinterpret_cast<const char*>(block.text) + offset, length);
+}
+
+bool IrReader::fail(const QString& message) {
+    error = message;
+    close();
+    return false;
+}
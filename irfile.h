@@ -0,0 +1,307 @@
+#ifndef IRFILE_H
+#define IRFILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include "token.h"
+#include "quad.h"
+
+/*
+ * 编译结果的二进制文件格式（.cpir），全部整数为小端序。
+ *
+ * 文件头 16 字节：
+ *   char   magic[4]   "CPIR"
+ *   u16    major      主版本号，读取方只接受相同的主版本
+ *   u16    minor      次版本号，只会在记录末尾追加字段
+ *   u32    flags      保留，为 0
+ *   u32    reserved   保留，为 0
+ *
+ * 之后是若干块，每块由块头、count 条定长记录和文本区组成，整块补零到 8 字节对齐：
+ *   u16    kind       IrBlockKind
+ *   u16    stride     每条记录的字节数，不小于本版本的记录大小
+ *   u32    count      记录条数
+ *   u32    textBytes  文本区的字节数，文本为 UTF-8
+ *   u32    first      本块第一条记录在同类记录中的序号
+ *
+ * 记录中的文本以 (text, length) 表示：text 为相对本块文本区起点的字节偏移。
+ * 文件以 kind 为 END 的空块结束；缺少结束块说明写入方中途退出，已完整写入的块仍可读取。
+ */
+
+/**
+ * @brief 数据块的种类。
+ */
+enum class IrBlockKind : quint16 {
+    END = 0,    ///< 结束块，没有记录
+    TOKENS = 1, ///< IrTokenRecord
+    QUADS = 2   ///< IrQuadRecord
+};
+
+/**
+ * @brief Token 记录，16 字节。
+ */
+struct IrTokenRecord {
+    quint8 type;        ///< TokenType。
+    quint8 reserved[3]; ///< 保留，为 0。
+    quint32 offset;     ///< Token 在源文件中的偏移量（UTF-16 码元下标）。
+    quint32 text;       ///< 文本在文本区中的偏移。
+    quint32 length;     ///< 文本的字节数；为 0 时文本即 tokenSpelling(type)。
+};
+
+/**
+ * @brief 四元式操作数记录，16 字节。
+ */
+struct IrOperandRecord {
+    quint8 kind;        ///< OperandKind。
+    quint8 reserved[3]; ///< 保留，为 0。
+    qint32 id;          ///< 临时变量编号或跳转目标下标。
+    quint32 text;       ///< 名字或常数的文本在文本区中的偏移。
+    quint32 length;     ///< 文本的字节数。
+};
+
+/**
+ * @brief 四元式记录，52 字节。
+ */
+struct IrQuadRecord {
+    quint8 op;              ///< QuadOp。
+    quint8 reserved[3];     ///< 保留，为 0。
+    IrOperandRecord arg1;   ///< 第一个操作数。
+    IrOperandRecord arg2;   ///< 第二个操作数。
+    IrOperandRecord result; ///< 结果或跳转目标。
+};
+
+static_assert(sizeof(IrTokenRecord) == 16, "IrTokenRecord 的布局是文件格式的一部分");
+static_assert(sizeof(IrQuadRecord) == 52, "IrQuadRecord 的布局是文件格式的一部分");
+
+/**
+ * @class IrWriter
+ * @brief 增量写出 Token 流与四元式，格式为 .cpir 二进制或 JSON Lines。
+ *
+ * 记录先编码到当前块的缓冲区，块满后封存；封存的块头、记录与文本区作为独立的
+ * 缓冲区排队，累计到一定大小后用一次 writev() 写出，既不逐条调用 write()，
+ * 也不把各部分拼接成一整块再写。不支持 writev() 的平台依次写出各缓冲区。
+ *
+ * JSON Lines 每行一个对象，第一行为 {"format":"cpir","version":主版本号}，之后为：
+ *   {"token":序号,"type":"IDENTIFIER","text":"x","offset":12}
+ *   {"quad":序号,"op":"+","arg1":{"name":"a"},"arg2":{"const":"1"},"result":{"temp":1}}
+ * 操作数为 null、{"name":…}、{"const":…}、{"temp":编号} 或 {"label":下标}。
+ */
+class IrWriter {
+public:
+    /**
+     * @brief 输出格式。
+     */
+    enum class Format {
+        Binary,    ///< .cpir 二进制格式
+        JsonLines  ///< 每行一个 JSON 对象
+    };
+
+    /**
+     * @brief 构造写入器。
+     * @param format 输出格式。
+     */
+    explicit IrWriter(Format format = Format::Binary);
+
+    /**
+     * @brief 析构时关闭文件，写出尚未写出的内容。
+     */
+    ~IrWriter();
+
+    IrWriter(const IrWriter&) = delete;
+    IrWriter& operator=(const IrWriter&) = delete;
+
+    /**
+     * @brief 创建输出文件并写入文件头。
+     * @param path 文件路径，"-" 表示标准输出。
+     * @return 文件无法创建时返回 false。
+     */
+    bool open(const QString& path);
+
+    /**
+     * @brief 追加一个 Token。
+     */
+    void writeToken(const Token& token);
+
+    /**
+     * @brief 追加 tokens 中从 first 开始的 count 个 Token，count 为负数时直到末尾。
+     */
+    void writeTokens(const QVector<Token>& tokens, qsizetype first = 0, qsizetype count = -1);
+
+    /**
+     * @brief 追加一条四元式。
+     */
+    void writeQuad(const Quad& quad);
+
+    /**
+     * @brief 追加一段四元式。
+     */
+    void writeQuads(const QVector<Quad>& quads);
+
+    /**
+     * @brief 写出全部缓冲内容和结束块，关闭文件。
+     * @return 写入过程中没有出错时返回 true。
+     */
+    bool close();
+
+    /**
+     * @brief 返回最近一次错误的描述。
+     */
+    QString errorString() const;
+
+private:
+    /**
+     * @brief 开始一个新块；当前块种类不同或已满时先封存当前块。
+     */
+    void beginRecord(IrBlockKind kind);
+
+    /**
+     * @brief 把文本追加到当前块的文本区。
+     * @return 文本在文本区中的偏移。
+     */
+    quint32 appendText(const QString& text, quint32& length);
+
+    /**
+     * @brief 编码一个操作数。
+     */
+    IrOperandRecord encodeOperand(const Operand& operand);
+
+    /**
+     * @brief 封存当前块：块头、记录与文本区排入待写队列。
+     */
+    void sealBlock();
+
+    /**
+     * @brief 把待写队列中的缓冲区一次写出。
+     */
+    bool flush();
+
+    /**
+     * @brief 追加一行 JSON，缓冲达到阈值时排入待写队列。
+     */
+    void appendLine(const QByteArray& line);
+
+    static constexpr int BLOCK_RECORDS = 8192;           ///< 每块最多的记录数。
+    static constexpr qint64 FLUSH_BYTES = 1 << 20;       ///< 待写队列达到该大小时写出。
+
+    Format format;             ///< 输出格式。
+    QFile file;                ///< 输出文件。
+    bool failed;               ///< 是否出现过写入错误。
+    QString error;             ///< 最近一次错误的描述。
+
+    IrBlockKind blockKind;     ///< 当前块的种类，END 表示没有未封存的块。
+    quint32 blockFirst;        ///< 当前块第一条记录的序号。
+    quint32 blockCount;        ///< 当前块的记录数。
+    QByteArray records;        ///< 当前块的记录，JSON Lines 格式下为尚未排队的文本行。
+    QByteArray text;           ///< 当前块的文本区。
+
+    QVector<QByteArray> queue; ///< 待写出的缓冲区，按顺序写出。
+    qint64 queuedBytes;        ///< 待写队列的总字节数。
+    qint64 tokenCount;         ///< 已写入的 Token 数。
+    qint64 quadCount;          ///< 已写入的四元式数。
+};
+
+/**
+ * @class IrReader
+ * @brief 通过内存映射读取 .cpir 文件。
+ *
+ * 打开时只校验文件头并建立块索引，不复制任何记录；按序号读取 Token 或四元式时
+ * 二分查找所在的块，直接从映射区解码该条记录，随机访问与顺序遍历都不需要
+ * 先把整个文件读入内存。
+ */
+class IrReader {
+public:
+    IrReader();
+    ~IrReader();
+
+    IrReader(const IrReader&) = delete;
+    IrReader& operator=(const IrReader&) = delete;
+
+    /**
+     * @brief 映射文件并建立块索引。
+     * @return 文件无法打开、无法映射或格式不符时返回 false。
+     */
+    bool open(const QString& path);
+
+    /**
+     * @brief 解除映射并关闭文件。
+     */
+    void close();
+
+    /**
+     * @brief 返回最近一次错误的描述。
+     */
+    QString errorString() const;
+
+    /**
+     * @brief 文件是否以结束块收尾，为 false 说明写入方没有正常关闭文件。
+     */
+    bool isComplete() const;
+
+    /**
+     * @brief 返回文件的次版本号。
+     */
+    int minorVersion() const;
+
+    /**
+     * @brief 返回 Token 的总数。
+     */
+    qsizetype tokenCount() const;
+
+    /**
+     * @brief 解码第 i 个 Token。
+     */
+    Token token(qsizetype i) const;
+
+    /**
+     * @brief 返回四元式的总数。
+     */
+    qsizetype quadCount() const;
+
+    /**
+     * @brief 解码第 i 条四元式。
+     */
+    Quad quad(qsizetype i) const;
+
+private:
+    /**
+     * @brief 块索引的一项。
+     */
+    struct Block {
+        quint32 first;         ///< 第一条记录的序号。
+        quint32 count;         ///< 记录条数。
+        quint16 stride;        ///< 每条记录的字节数。
+        const uchar *records;  ///< 记录区在映射区中的起点。
+        const uchar *text;     ///< 文本区在映射区中的起点。
+        quint32 textBytes;     ///< 文本区的字节数。
+    };
+
+    /**
+     * @brief 查找第 i 条记录所在的块。
+     * @return 记录的起点；序号越界时返回 nullptr。
+     */
+    const uchar *locate(const QVector<Block>& blocks, qsizetype i, const Block **block) const;
+
+    /**
+     * @brief 解码操作数记录。
+     */
+    static Operand decodeOperand(const uchar *record, const Block& block);
+
+    /**
+     * @brief 从块的文本区取出 UTF-8 文本，越界时返回空字符串。
+     */
+    static QString textAt(const Block& block, quint32 offset, quint32 length);
+
+    bool fail(const QString& message);
+
+    QFile file;                 ///< 被映射的文件。
+    const uchar *data;          ///< 映射区起点。
+    qint64 size;                ///< 文件大小。
+    QVector<Block> tokenBlocks; ///< Token 块，按序号排列。
+    QVector<Block> quadBlocks;  ///< 四元式块，按序号排列。
+    int minor;                  ///< 次版本号。
+    bool complete;              ///< 是否读到结束块。
+    QString error;              ///< 最近一次错误的描述。
+};
+
+#endif // IRFILE_H
@@ -0,0 +1,306 @@
+#include "lalrparser.h"
+#include "lalrtables.h"
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+// 二元运算的结果类型：算术运算取较宽的类型（char < int < float），比较运算为 int
+TokenType binaryResultType(TokenType op, TokenType left, TokenType right) {
+    switch (op) {
+        case TokenType::PLUS:
+        case TokenType::MINUS:
+        case TokenType::MULTIPLY:
+        case TokenType::DIVIDE:
+            if (left == TokenType::FLOAT || right == TokenType::FLOAT) return TokenType::FLOAT;
+            return TokenType::INT;
+        default:
+            return TokenType::INT;
+    }
+}
+
+constexpr int TERMINAL = -1; // StackEntry::symbol：由移进压入的项
+
+} // namespace
+
+LalrParser::LalrParser(const QVector<Token>& tokens, const LineIndex* lines,
+                       std::pmr::memory_resource* memory)
+    : tokens(tokens), lines(lines), memory(memory), end(std::max(0, int(tokens.size()) - 1)),
+      stack(memory), maxDepth(0), lastError(-1), diags(), ir(nullptr), consoleOutput(true),
+      semanticChecks(false), symbols(memory), returnType(TokenType::INT), hadError(false) {}
+
+void LalrParser::setMaxErrors(int maxErrors) {
+    diags = DiagnosticBuffer(maxErrors);
+}
+
+const DiagnosticBuffer& LalrParser::diagnostics() const {
+    return diags;
+}
+
+void LalrParser::setQuadBuilder(QuadBuilder* builder) {
+    ir = builder;
+}
+
+void LalrParser::setConsoleOutput(bool enabled) {
+    consoleOutput = enabled;
+}
+
+void LalrParser::setSemanticChecks(bool enabled) {
+    semanticChecks = enabled;
+}
+
+int LalrParser::maxStackDepth() const {
+    return maxDepth;
+}
+
+bool LalrParser::parse() {
+    stack.clear();
+    stack.push_back({0, TERMINAL, Value()});
+    int index = 0;
+    bool accepted = false;
+    for (;;) {
+        const int action = actionAt(stack.back().state, index);
+        if (action > 0) {
+            // 移进：终结符的语义值记下 Token 本身
+            Value value;
+            value.type = typeAt(index);
+            value.token = index;
+            stack.push_back({action - 1, TERMINAL, std::move(value)});
+            maxDepth = std::max(maxDepth, int(stack.size()));
+            ++index;
+        } else if (action < 0) {
+            const int rule = -action - 1;
+            if (rule == 0) {
+                accepted = true;
+                break;
+            }
+            reduce(rule);
+        } else if (!recover(index)) {
+            break;
+        }
+    }
+
+    const bool result = accepted && !hadError;
+    printResult(result);
+    return result;
+}
+
+void LalrParser::reduce(int rule) {
+    const lalr::Rule& production = lalr::RULES[rule];
+    const int length = production.length;
+    // rhs[i] 为右部第 i + 1 个符号的语义值
+    const StackEntry* rhs = stack.data() + stack.size() - length;
+    Value result = length > 0 ? rhs[0].value : Value();
+
+    switch (production.action) {
+        case lalr::Reduction::NONE:
+            break;
+
+        // 声明
+        case lalr::Reduction::DECLARE_VARIABLE:
+            // type IDENTIFIER：名字的作用域从声明符之后开始
+            declareSymbol(rhs[1].value.token, rhs[0].value.type, false);
+            result.type = rhs[0].value.type;
+            result.token = rhs[1].value.token;
+            break;
+        case lalr::Reduction::INITIALIZE: {
+            // var_head '=' expression ';'
+            const Value& head = rhs[0].value;
+            checkConversion(head.type, rhs[2].value.type, head.token);
+            if (ir) {
+                ir->emitQuad(QuadOp::ASSIGN, rhs[2].value.place, Operand(),
+                             Operand::name(tokens[head.token].value));
+            }
+            break;
+        }
+        case lalr::Reduction::DECLARE_FUNCTION: {
+            // type IDENTIFIER '(' ')'：语义值保存外层的返回类型，函数结束时恢复
+            const int name = rhs[1].value.token;
+            declareSymbol(name, rhs[0].value.type, true);
+            if (ir) ir->emitQuad(QuadOp::FUNC, Operand::name(tokens[name].value));
+            result.type = returnType;
+            result.token = name;
+            returnType = rhs[0].value.type;
+            break;
+        }
+        case lalr::Reduction::END_FUNCTION:
+            returnType = rhs[0].value.type;
+            break;
+
+        // 语句
+        case lalr::Reduction::OPEN_BLOCK:
+            if (semanticChecks) symbols.enterScope();
+            break;
+        case lalr::Reduction::CLOSE_BLOCK:
+            if (semanticChecks) symbols.exitScope();
+            break;
+        case lalr::Reduction::BEGIN_IF:
+            // IF '(' expression ')'：条件为假时跳过if语句体，目标待回填
+            result.jump = ir ? ir->emitQuad(QuadOp::JZ, rhs[2].value.place) : -1;
+            break;
+        case lalr::Reduction::BEGIN_ELSE:
+            // if_head statement ELSE：then 分支末尾跳过 else 分支
+            result.jump = -1;
+            if (ir) {
+                result.jump = ir->emitQuad(QuadOp::JMP);
+                ir->patch(rhs[0].value.jump, ir->nextIndex());
+            }
+            break;
+        case lalr::Reduction::END_IF:
+        case lalr::Reduction::END_ELSE:
+            if (ir) ir->patch(rhs[0].value.jump, ir->nextIndex());
+            break;
+        case lalr::Reduction::RETURN_VOID:
+            if (ir) ir->emitQuad(QuadOp::RETURN);
+            break;
+        case lalr::Reduction::RETURN_VALUE:
+            checkConversion(returnType, rhs[1].value.type, rhs[0].value.token);
+            if (ir) ir->emitQuad(QuadOp::RETURN, rhs[1].value.place);
+            break;
+
+        // 表达式
+        case lalr::Reduction::ASSIGN_TARGET:
+            // IDENTIFIER '='：在右侧之前查找目标
+            result.type = useSymbol(rhs[0].value.token);
+            break;
+        case lalr::Reduction::ASSIGN: {
+            const Value& target = rhs[0].value;
+            checkConversion(target.type, rhs[1].value.type, target.token);
+            result = target;
+            if (ir) {
+                result.place = Operand::name(tokens[target.token].value);
+                ir->emitQuad(QuadOp::ASSIGN, rhs[1].value.place, Operand(), result.place);
+            }
+            break;
+        }
+        case lalr::Reduction::BINARY: {
+            const TokenType op = rhs[1].value.type;
+            if (ir) {
+                result.place = ir->newTemp();
+                ir->emitQuad(binaryQuadOp(op), rhs[0].value.place, rhs[2].value.place, result.place);
+            }
+            result.type = binaryResultType(op, rhs[0].value.type, rhs[2].value.type);
+            break;
+        }
+        case lalr::Reduction::NOT:
+        case lalr::Reduction::NEGATE: {
+            const bool isNot = production.action == lalr::Reduction::NOT;
+            result = rhs[1].value;
+            if (ir) {
+                result.place = ir->newTemp();
+                ir->emitQuad(isNot ? QuadOp::NOT : QuadOp::NEG, rhs[1].value.place, Operand(), result.place);
+            }
+            if (isNot) result.type = TokenType::INT;
+            break;
+        }
+        case lalr::Reduction::CONSTANT: {
+            const QString& text = tokens[rhs[0].value.token].value;
+            if (ir) result.place = Operand::constant(text);
+            result.type = text.contains('.') ? TokenType::FLOAT : TokenType::INT;
+            break;
+        }
+        case lalr::Reduction::VARIABLE:
+            if (ir) result.place = Operand::name(tokens[rhs[0].value.token].value);
+            result.type = useSymbol(rhs[0].value.token);
+            break;
+        case lalr::Reduction::GROUP:
+            result = rhs[1].value;
+            break;
+    }
+
+    stack.resize(stack.size() - length);
+    const int lhs = static_cast<int>(production.lhs);
+    stack.push_back({lalr::GOTO[stack.back().state][lhs], lhs, std::move(result)});
+    maxDepth = std::max(maxDepth, int(stack.size()));
+}
+
+void LalrParser::popEntry() {
+    const StackEntry& top = stack.back();
+    // 块与函数头的效果要到整个产生式归约时才撤销，被错误恢复弹出时在这里撤销
+    if (top.symbol == static_cast<int>(lalr::Symbol::BLOCK_OPEN) && semanticChecks) {
+        symbols.exitScope();
+    } else if (top.symbol == static_cast<int>(lalr::Symbol::FUNC_HEAD)) {
+        returnType = top.value.type;
+    }
+    stack.pop_back();
+}
+
+bool LalrParser::recover(int& index) {
+    TokenTypeSet expected;
+    const int state = stack.back().state;
+    for (int column = 0; column < lalr::TERMINAL_COUNT; ++column) {
+        if (lalr::ACTION[state][column] != 0) expected.insert(lalr::TERMINALS[column]);
+    }
+    const int at = std::min(index, end);
+    if (!error(at, DiagCode::UNEXPECTED_TOKEN, expected)) return false;
+    if (index >= end || tokens.isEmpty()) return false;
+
+    // 弹栈到最近的声明列表，在那里可以开始一条新的声明或语句
+    const int declList = static_cast<int>(lalr::Symbol::DECL_LIST);
+    while (stack.size() > 1 && stack.back().symbol != declList) {
+        popEntry();
+    }
+
+    // 当前 Token 能开始新的声明（或闭合所在的块）时原地继续；否则跳到下一个同步点。
+    // 同一个 Token 上第二次出错时一定跳过，保证每次恢复都有进展
+    if (actionAt(stack.back().state, index) != 0 && index != lastError) {
+        lastError = index;
+        return true;
+    }
+    lastError = index;
+    if (!structure) structure.emplace(tokens, memory);
+    index = std::min(structure->nextSyncPoint(index + 1), end);
+    return true;
+}
+
+TokenType LalrParser::typeAt(int index) const {
+    return index >= end ? TokenType::EOF_TOKEN : tokens[index].type;
+}
+
+int LalrParser::actionAt(int state, int index) const {
+    const int column = lalr::column(typeAt(index));
+    return column < 0 ? 0 : lalr::ACTION[state][column];
+}
+
+void LalrParser::declareSymbol(int name, TokenType type, bool isFunction) {
+    if (!semanticChecks) return;
+    if (!symbols.declare(tokens[name].value, type, isFunction, name)) {
+        error(name, DiagCode::REDECLARED_IDENTIFIER);
+    }
+}
+
+TokenType LalrParser::useSymbol(int name) {
+    if (!semanticChecks) return TokenType::INT;
+    const Symbol* symbol = symbols.lookup(tokens[name].value);
+    if (!symbol) {
+        error(name, DiagCode::UNDECLARED_IDENTIFIER);
+        return TokenType::INT;
+    }
+    if (symbol->isFunction) {
+        error(name, DiagCode::FUNCTION_AS_VALUE);
+    }
+    return symbol->type;
+}
+
+void LalrParser::checkConversion(TokenType target, TokenType value, int at) {
+    if (!semanticChecks) return;
+    if (value == TokenType::FLOAT && target != TokenType::FLOAT) {
+        error(at, DiagCode::TYPE_MISMATCH);
+    }
+}
+
+bool LalrParser::error(int index, DiagCode code, TokenTypeSet expected) {
+    hadError = true;
+    return diags.report(code, index, expected);
+}
+
+void LalrParser::printResult(bool result) const {
+    if (!consoleOutput) return;
+    if (result) {
+        qDebug() << "语法分析成功！";
+        return;
+    }
+    for (const QString& message : diags.formatAll(tokens, lines)) {
+        qWarning() << message;
+    }
+}
@@ -0,0 +1,169 @@
+#ifndef LALRPARSER_H
+#define LALRPARSER_H
+
+#include <QVector>
+#include <QString>
+#include <memory_resource>
+#include <optional>
+#include "token.h"
+#include "lineindex.h"
+#include "structuralindex.h"
+#include "diagnostics.h"
+#include "quad.h"
+#include "symboltable.h"
+
+/**
+ * @class LalrParser
+ * @brief 表驱动的 LALR(1) 语法分析器，接受与 Parser 相同的语言，生成相同的四元式与语义错误。
+ *
+ * 分析表由 tools/lalrgen 根据 tools/c_subset.grammar 生成（见 lalrtables.h），分析过程
+ * 只有一个循环和一个堆上的显式状态栈，不做任何递归：嵌套再深也只是栈变长，
+ * 不会耗尽线程栈，每个 Token 的代价也与嵌套深度无关。语义动作在归约时执行，
+ * 语义值随状态一起保存在栈上。
+ *
+ * 语法错误统一报告为 UNEXPECTED_TOKEN，期望集合取自出错状态的动作表行；恢复时
+ * 弹栈到最近的声明列表，再跳到下一个同步点继续分析。
+ */
+class LalrParser {
+public:
+    /**
+     * @brief 构造函数，初始化语法分析器。
+     * @param tokens 词法分析器生成的Token序列。
+     * @param lines 源代码的行首索引，用于在错误信息中给出行列号；为空时只报告偏移量。
+     * @param memory 状态栈与符号表使用的内存资源，通常为编译会话的内存池（见 CompileArena）。
+     */
+    LalrParser(const QVector<Token>& tokens, const LineIndex* lines = nullptr,
+               std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * @brief 执行语法分析。
+     * @return 语法分析成功返回true，否则返回false。
+     */
+    bool parse();
+
+    /**
+     * @brief 设置最多记录的错误条数，达到上限后立即停止分析。
+     * @param maxErrors 错误上限。
+     */
+    void setMaxErrors(int maxErrors);
+
+    /**
+     * @brief 返回分析过程中记录的结构化错误信息。
+     */
+    const DiagnosticBuffer& diagnostics() const;
+
+    /**
+     * @brief 设置四元式生成缓冲区，分析的同时进行语法制导翻译。
+     * @param builder 四元式缓冲区，由调用方持有；为空时只做语法检查。
+     */
+    void setQuadBuilder(QuadBuilder* builder);
+
+    /**
+     * @brief 设置分析结束后是否把结果与错误信息输出到控制台，默认输出。
+     * @param enabled 是否输出。
+     */
+    void setConsoleOutput(bool enabled);
+
+    /**
+     * @brief 设置是否在分析的同时进行语义检查，默认关闭，检查内容与 Parser 相同。
+     * @param enabled 是否检查。
+     */
+    void setSemanticChecks(bool enabled);
+
+    /**
+     * @brief 返回分析过程中状态栈的最大深度。
+     */
+    int maxStackDepth() const;
+
+private:
+    /**
+     * @brief 栈上的语义值。
+     */
+    struct Value {
+        Operand place;                     ///< 表达式结果所在的位置。
+        TokenType type = TokenType::INT;   ///< 表达式或声明的类型；终结符为其 Token 类型。
+        int token = -1;                    ///< 相关 Token 的下标：终结符本身、声明的名字或赋值目标。
+        int jump = -1;                     ///< 待回填的跳转四元式下标。
+    };
+
+    /**
+     * @brief 状态栈的一项。
+     */
+    struct StackEntry {
+        int state;    ///< 分析状态。
+        int symbol;   ///< 转入该状态的非终结符（lalr::Symbol），终结符为 -1。
+        Value value;  ///< 语义值。
+    };
+
+    /**
+     * @brief 按第 rule 条产生式归约：执行语义动作，弹出右部并按转移表压入左部。
+     */
+    void reduce(int rule);
+
+    /**
+     * @brief 弹出栈顶一项，撤销尚未完成的标记非终结符的副作用（作用域、返回类型）。
+     */
+    void popEntry();
+
+    /**
+     * @brief 报告语法错误并恢复。
+     * @param index 当前 Token 的下标，恢复时可能向后跳过若干 Token。
+     * @return 可以继续分析返回 true；已到输入末尾或错误数达到上限时返回 false。
+     */
+    bool recover(int& index);
+
+    /**
+     * @brief 返回下标为 index 的 Token 的类型，超出分析范围时视为 EOF_TOKEN。
+     */
+    TokenType typeAt(int index) const;
+
+    /**
+     * @brief 返回状态 state 在当前 Token 上的动作表项，文法中没有的 Token 返回 0（出错）。
+     */
+    int actionAt(int state, int index) const;
+
+    /**
+     * @brief 在当前作用域中声明下标为 name 的标识符，重复声明时报告错误。
+     */
+    void declareSymbol(int name, TokenType type, bool isFunction);
+
+    /**
+     * @brief 查找下标为 name 的标识符，未声明或为函数时报告错误。
+     * @return 名字的类型；未声明时返回 INT。
+     */
+    TokenType useSymbol(int name);
+
+    /**
+     * @brief 检查把 value 类型的值隐式转换为 target 类型是否允许，不允许时在下标 at 处报告错误。
+     */
+    void checkConversion(TokenType target, TokenType value, int at);
+
+    /**
+     * @brief 记录一条错误。
+     * @return 缓冲区已满时返回 false，分析随即结束。
+     */
+    bool error(int index, DiagCode code, TokenTypeSet expected = TokenTypeSet());
+
+    /**
+     * @brief 输出分析结果：成功信息，或格式化后的全部错误信息。
+     */
+    void printResult(bool result) const;
+
+    const QVector<Token>& tokens;                ///< 词法分析得到的Token列表
+    const LineIndex* lines;                      ///< 源代码行首索引，可为空
+    std::pmr::memory_resource* memory;           ///< 按会话分配的内存资源
+    std::optional<StructuralIndex> structure;    ///< 错误恢复用的同步点索引，第一次出错时才构建
+    int end;                                     ///< EOF_TOKEN 的下标
+    std::pmr::vector<StackEntry> stack;          ///< 显式状态栈
+    int maxDepth;                                ///< 状态栈的最大深度
+    int lastError;                               ///< 上一次报告错误的 Token 下标，用于保证恢复有进展
+    DiagnosticBuffer diags;                      ///< 结构化错误信息缓冲区
+    QuadBuilder* ir;                             ///< 四元式缓冲区，为空时不生成中间代码
+    bool consoleOutput;                          ///< 是否向控制台输出分析结果
+    bool semanticChecks;                         ///< 是否进行语义检查
+    SymbolTable symbols;                         ///< 作用域符号表
+    TokenType returnType;                        ///< 当前函数的返回类型
+    bool hadError;                               ///< 标记是否出现错误
+};
+
+#endif // LALRPARSER_H
@@ -0,0 +1,353 @@
+// 由 tools/lalrgen 根据 tools/c_subset.grammar 生成，请勿手工修改。
+// 修改文法后执行 make lalrtables 重新生成。
+// 165 个规范 LR(1) 项目集合并为 78 个 LALR(1) 状态，1 个移进/归约冲突按移进解决。
+
+#ifndef LALRTABLES_H
+#define LALRTABLES_H
+
+#include <cstdint>
+#include "token.h"
+
+namespace lalr {
+
+constexpr int STATE_COUNT = 78;
+constexpr int TERMINAL_COUNT = 26;
+constexpr int NONTERMINAL_COUNT = 19;
+constexpr int RULE_COUNT = 46;
+
+/// 非终结符。
+enum class Symbol : std::uint8_t {
+    PROGRAM,
+    DECL_LIST,
+    DECLARATION,
+    VAR_HEAD,
+    FUNC_HEAD,
+    TYPE,
+    STATEMENT,
+    BLOCK_OPEN,
+    IF_HEAD,
+    ELSE_HEAD,
+    EXPRESSION,
+    ASSIGNMENT,
+    ASSIGN_TARGET,
+    EQUALITY,
+    COMPARISON,
+    TERM,
+    FACTOR,
+    UNARY,
+    PRIMARY,
+};
+
+/// 归约时执行的语义动作，NONE 表示把第一个符号的语义值传给左部。
+enum class Reduction : std::uint8_t {
+    NONE,
+    END_FUNCTION,
+    INITIALIZE,
+    DECLARE_VARIABLE,
+    DECLARE_FUNCTION,
+    CLOSE_BLOCK,
+    END_IF,
+    END_ELSE,
+    RETURN_VOID,
+    RETURN_VALUE,
+    OPEN_BLOCK,
+    BEGIN_IF,
+    BEGIN_ELSE,
+    ASSIGN,
+    ASSIGN_TARGET,
+    BINARY,
+    NOT,
+    NEGATE,
+    CONSTANT,
+    VARIABLE,
+    GROUP,
+};
+
+/// 产生式：左部、右部长度与语义动作。第 0 条是增广产生式，按它归约即接受。
+struct Rule {
+    Symbol lhs;
+    std::uint8_t length;
+    Reduction action;
+};
+
+constexpr Rule RULES[RULE_COUNT] = {
+    {Symbol::PROGRAM, 1, Reduction::NONE},              // 0: $accept -> program
+    {Symbol::PROGRAM, 1, Reduction::NONE},              // 1: program -> decl_list
+    {Symbol::DECL_LIST, 0, Reduction::NONE},            // 2: decl_list -> %empty
+    {Symbol::DECL_LIST, 2, Reduction::NONE},            // 3: decl_list -> decl_list declaration
+    {Symbol::DECLARATION, 2, Reduction::END_FUNCTION},  // 4: declaration -> func_head statement
+    {Symbol::DECLARATION, 2, Reduction::NONE},          // 5: declaration -> var_head SEMICOLON
+    {Symbol::DECLARATION, 4, Reduction::INITIALIZE},    // 6: declaration -> var_head ASSIGNMENT expression SEMICOLON
+    {Symbol::DECLARATION, 1, Reduction::NONE},          // 7: declaration -> statement
+    {Symbol::VAR_HEAD, 2, Reduction::DECLARE_VARIABLE}, // 8: var_head -> type IDENTIFIER
+    {Symbol::FUNC_HEAD, 4, Reduction::DECLARE_FUNCTION}, // 9: func_head -> type IDENTIFIER LEFT_PAREN RIGHT_PAREN
+    {Symbol::TYPE, 1, Reduction::NONE},                 // 10: type -> INT
+    {Symbol::TYPE, 1, Reduction::NONE},                 // 11: type -> FLOAT
+    {Symbol::TYPE, 1, Reduction::NONE},                 // 12: type -> CHAR
+    {Symbol::STATEMENT, 3, Reduction::CLOSE_BLOCK},     // 13: statement -> block_open decl_list RIGHT_BRACE
+    {Symbol::STATEMENT, 2, Reduction::END_IF},          // 14: statement -> if_head statement
+    {Symbol::STATEMENT, 2, Reduction::END_ELSE},        // 15: statement -> else_head statement
+    {Symbol::STATEMENT, 2, Reduction::RETURN_VOID},     // 16: statement -> RETURN SEMICOLON
+    {Symbol::STATEMENT, 3, Reduction::RETURN_VALUE},    // 17: statement -> RETURN expression SEMICOLON
+    {Symbol::STATEMENT, 2, Reduction::NONE},            // 18: statement -> expression SEMICOLON
+    {Symbol::BLOCK_OPEN, 1, Reduction::OPEN_BLOCK},     // 19: block_open -> LEFT_BRACE
+    {Symbol::IF_HEAD, 4, Reduction::BEGIN_IF},          // 20: if_head -> IF LEFT_PAREN expression RIGHT_PAREN
+    {Symbol::ELSE_HEAD, 3, Reduction::BEGIN_ELSE},      // 21: else_head -> if_head statement ELSE
+    {Symbol::EXPRESSION, 1, Reduction::NONE},           // 22: expression -> assignment
+    {Symbol::ASSIGNMENT, 2, Reduction::ASSIGN},         // 23: assignment -> assign_target assignment
+    {Symbol::ASSIGNMENT, 1, Reduction::NONE},           // 24: assignment -> equality
+    {Symbol::ASSIGN_TARGET, 2, Reduction::ASSIGN_TARGET}, // 25: assign_target -> IDENTIFIER ASSIGNMENT
+    {Symbol::EQUALITY, 3, Reduction::BINARY},           // 26: equality -> equality EQUAL comparison
+    {Symbol::EQUALITY, 3, Reduction::BINARY},           // 27: equality -> equality NOT_EQUAL comparison
+    {Symbol::EQUALITY, 1, Reduction::NONE},             // 28: equality -> comparison
+    {Symbol::COMPARISON, 3, Reduction::BINARY},         // 29: comparison -> comparison LESS term
+    {Symbol::COMPARISON, 3, Reduction::BINARY},         // 30: comparison -> comparison LESS_EQUAL term
+    {Symbol::COMPARISON, 3, Reduction::BINARY},         // 31: comparison -> comparison GREATER term
+    {Symbol::COMPARISON, 3, Reduction::BINARY},         // 32: comparison -> comparison GREATER_EQUAL term
+    {Symbol::COMPARISON, 1, Reduction::NONE},           // 33: comparison -> term
+    {Symbol::TERM, 3, Reduction::BINARY},               // 34: term -> term PLUS factor
+    {Symbol::TERM, 3, Reduction::BINARY},               // 35: term -> term MINUS factor
+    {Symbol::TERM, 1, Reduction::NONE},                 // 36: term -> factor
+    {Symbol::FACTOR, 3, Reduction::BINARY},             // 37: factor -> factor MULTIPLY unary
+    {Symbol::FACTOR, 3, Reduction::BINARY},             // 38: factor -> factor DIVIDE unary
+    {Symbol::FACTOR, 1, Reduction::NONE},               // 39: factor -> unary
+    {Symbol::UNARY, 2, Reduction::NOT},                 // 40: unary -> BANG unary
+    {Symbol::UNARY, 2, Reduction::NEGATE},              // 41: unary -> MINUS unary
+    {Symbol::UNARY, 1, Reduction::NONE},                // 42: unary -> primary
+    {Symbol::PRIMARY, 1, Reduction::CONSTANT},          // 43: primary -> NUMBER
+    {Symbol::PRIMARY, 1, Reduction::VARIABLE},          // 44: primary -> IDENTIFIER
+    {Symbol::PRIMARY, 3, Reduction::GROUP},             // 45: primary -> LEFT_PAREN expression RIGHT_PAREN
+};
+
+/// 动作表的列对应的终结符。
+constexpr TokenType TERMINALS[TERMINAL_COUNT] = {
+    TokenType::INT,
+    TokenType::FLOAT,
+    TokenType::CHAR,
+    TokenType::IF,
+    TokenType::ELSE,
+    TokenType::RETURN,
+    TokenType::IDENTIFIER,
+    TokenType::NUMBER,
+    TokenType::LEFT_PAREN,
+    TokenType::RIGHT_PAREN,
+    TokenType::LEFT_BRACE,
+    TokenType::RIGHT_BRACE,
+    TokenType::SEMICOLON,
+    TokenType::ASSIGNMENT,
+    TokenType::EQUAL,
+    TokenType::NOT_EQUAL,
+    TokenType::LESS,
+    TokenType::LESS_EQUAL,
+    TokenType::GREATER,
+    TokenType::GREATER_EQUAL,
+    TokenType::PLUS,
+    TokenType::MINUS,
+    TokenType::MULTIPLY,
+    TokenType::DIVIDE,
+    TokenType::BANG,
+    TokenType::EOF_TOKEN,
+};
+
+/// 返回终结符在动作表中的列，文法中没有的 Token 返回 -1。
+constexpr int column(TokenType type) {
+    switch (type) {
+        case TokenType::INT: return 0;
+        case TokenType::FLOAT: return 1;
+        case TokenType::CHAR: return 2;
+        case TokenType::IF: return 3;
+        case TokenType::ELSE: return 4;
+        case TokenType::RETURN: return 5;
+        case TokenType::IDENTIFIER: return 6;
+        case TokenType::NUMBER: return 7;
+        case TokenType::LEFT_PAREN: return 8;
+        case TokenType::RIGHT_PAREN: return 9;
+        case TokenType::LEFT_BRACE: return 10;
+        case TokenType::RIGHT_BRACE: return 11;
+        case TokenType::SEMICOLON: return 12;
+        case TokenType::ASSIGNMENT: return 13;
+        case TokenType::EQUAL: return 14;
+        case TokenType::NOT_EQUAL: return 15;
+        case TokenType::LESS: return 16;
+        case TokenType::LESS_EQUAL: return 17;
+        case TokenType::GREATER: return 18;
+        case TokenType::GREATER_EQUAL: return 19;
+        case TokenType::PLUS: return 20;
+        case TokenType::MINUS: return 21;
+        case TokenType::MULTIPLY: return 22;
+        case TokenType::DIVIDE: return 23;
+        case TokenType::BANG: return 24;
+        case TokenType::EOF_TOKEN: return 25;
+        default: return -1;
+    }
+}
+
+/// 动作表项：0 为出错，v > 0 为移进并转到状态 v - 1，v < 0 为按第 -v - 1 条产生式归约。
+using Entry = std::int8_t;
+
+constexpr Entry ACTION[STATE_COUNT][TERMINAL_COUNT] = {
+    {-3,-3,-3,-3,0,-3,-3,-3,-3,0,-3,0,0,0,0,0,0,0,0,0,0,-3,0,0,-3,-3},
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,-1},
+    {4,5,6,7,0,8,9,10,11,0,12,0,0,0,0,0,0,0,0,0,0,13,0,0,14,-2},
+    {0,0,0,0,0,0,-11,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,-12,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,-13,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,0,0,32,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,9,10,11,0,0,0,33,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,0,0,0,-45,0,0,-45,35,-45,-45,-45,-45,-45,-45,-45,-45,-45,-45,0,0},
+    {0,0,0,0,0,0,0,0,0,-44,0,0,-44,0,-44,-44,-44,-44,-44,-44,-44,-44,-44,-44,0,0},
+    {0,0,0,0,0,0,9,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {-20,-20,-20,-20,0,-20,-20,-20,-20,0,-20,-20,0,0,0,0,0,0,0,0,0,-20,0,0,-20,0},
+    {0,0,0,0,0,0,37,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,37,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {-4,-4,-4,-4,0,-4,-4,-4,-4,0,-4,-4,0,0,0,0,0,0,0,0,0,-4,0,0,-4,-4},
+    {0,0,0,0,0,0,0,0,0,0,0,0,40,41,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,0,0,7,0,8,9,10,11,0,12,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,43,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {-8,-8,-8,-8,0,-8,-8,-8,-8,0,-8,-8,0,0,0,0,0,0,0,0,0,-8,0,0,-8,-8},
+    {-3,-3,-3,-3,0,-3,-3,-3,-3,0,-3,-3,0,0,0,0,0,0,0,0,0,-3,0,0,-3,0},
+    {0,0,0,7,0,8,9,10,11,0,12,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,7,0,8,9,10,11,0,12,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,0,0,0,0,0,0,47,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,-23,0,0,-23,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,9,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,0,0,0,-25,0,0,-25,0,49,50,0,0,0,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,-29,0,0,-29,0,-29,-29,51,52,53,54,0,0,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,-34,0,0,-34,0,-34,-34,-34,-34,-34,-34,55,56,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,-37,0,0,-37,0,-37,-37,-37,-37,-37,-37,-37,-37,57,58,0,0},
+    {0,0,0,0,0,0,0,0,0,-40,0,0,-40,0,-40,-40,-40,-40,-40,-40,-40,-40,-40,-40,0,0},
+    {0,0,0,0,0,0,0,0,0,-43,0,0,-43,0,-43,-43,-43,-43,-43,-43,-43,-43,-43,-43,0,0},
+    {0,0,0,0,0,0,9,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {-17,-17,-17,-17,-17,-17,-17,-17,-17,0,-17,-17,0,0,0,0,0,0,0,0,0,-17,0,0,-17,-17},
+    {0,0,0,0,0,0,0,0,0,0,0,0,60,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,-26,-26,-26,0,0,0,0,0,0,0,0,0,0,0,0,-26,0,0,-26,0},
+    {0,0,0,0,0,0,0,0,0,61,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,-45,0,0,-45,0,-45,-45,-45,-45,-45,-45,-45,-45,-45,-45,0,0},
+    {0,0,0,0,0,0,0,0,0,-42,0,0,-42,0,-42,-42,-42,-42,-42,-42,-42,-42,-42,-42,0,0},
+    {0,0,0,0,0,0,0,0,0,-41,0,0,-41,0,-41,-41,-41,-41,-41,-41,-41,-41,-41,-41,0,0},
+    {-6,-6,-6,-6,0,-6,-6,-6,-6,0,-6,-6,0,0,0,0,0,0,0,0,0,-6,0,0,-6,-6},
+    {0,0,0,0,0,0,9,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {-5,-5,-5,-5,0,-5,-5,-5,-5,0,-5,-5,0,0,0,0,0,0,0,0,0,-5,0,0,-5,-5},
+    {0,0,0,0,0,0,0,0,63,0,0,0,-9,-9,0,0,0,0,0,0,0,0,0,0,0,0},
+    {4,5,6,7,0,8,9,10,11,0,12,64,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {-15,-15,-15,-15,65,-15,-15,-15,-15,0,-15,-15,0,0,0,0,0,0,0,0,0,-15,0,0,-15,-15},
+    {-16,-16,-16,-16,-16,-16,-16,-16,-16,0,-16,-16,0,0,0,0,0,0,0,0,0,-16,0,0,-16,-16},
+    {-19,-19,-19,-19,-19,-19,-19,-19,-19,0,-19,-19,0,0,0,0,0,0,0,0,0,-19,0,0,-19,-19},
+    {0,0,0,0,0,0,0,0,0,-24,0,0,-24,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,37,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,37,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,37,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,37,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,37,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,37,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,37,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,37,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,37,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,37,10,11,0,0,0,0,0,0,0,0,0,0,0,0,13,0,0,14,0},
+    {0,0,0,0,0,0,0,0,0,76,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {-18,-18,-18,-18,-18,-18,-18,-18,-18,0,-18,-18,0,0,0,0,0,0,0,0,0,-18,0,0,-18,-18},
+    {0,0,0,0,0,0,0,0,0,-46,0,0,-46,0,-46,-46,-46,-46,-46,-46,-46,-46,-46,-46,0,0},
+    {0,0,0,0,0,0,0,0,0,0,0,0,77,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,78,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {-14,-14,-14,-14,-14,-14,-14,-14,-14,0,-14,-14,0,0,0,0,0,0,0,0,0,-14,0,0,-14,-14},
+    {0,0,0,-22,0,-22,-22,-22,-22,0,-22,0,0,0,0,0,0,0,0,0,0,-22,0,0,-22,0},
+    {0,0,0,0,0,0,0,0,0,-27,0,0,-27,0,-27,-27,51,52,53,54,0,0,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,-28,0,0,-28,0,-28,-28,51,52,53,54,0,0,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,-30,0,0,-30,0,-30,-30,-30,-30,-30,-30,55,56,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,-31,0,0,-31,0,-31,-31,-31,-31,-31,-31,55,56,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,-32,0,0,-32,0,-32,-32,-32,-32,-32,-32,55,56,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,-33,0,0,-33,0,-33,-33,-33,-33,-33,-33,55,56,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,-35,0,0,-35,0,-35,-35,-35,-35,-35,-35,-35,-35,57,58,0,0},
+    {0,0,0,0,0,0,0,0,0,-36,0,0,-36,0,-36,-36,-36,-36,-36,-36,-36,-36,57,58,0,0},
+    {0,0,0,0,0,0,0,0,0,-38,0,0,-38,0,-38,-38,-38,-38,-38,-38,-38,-38,-38,-38,0,0},
+    {0,0,0,0,0,0,0,0,0,-39,0,0,-39,0,-39,-39,-39,-39,-39,-39,-39,-39,-39,-39,0,0},
+    {0,0,0,-21,0,-21,-21,-21,-21,0,-21,0,0,0,0,0,0,0,0,0,0,-21,0,0,-21,0},
+    {-7,-7,-7,-7,0,-7,-7,-7,-7,0,-7,-7,0,0,0,0,0,0,0,0,0,-7,0,0,-7,-7},
+    {0,0,0,-10,0,-10,-10,-10,-10,0,-10,0,0,0,0,0,0,0,0,0,0,-10,0,0,-10,0},
+};
+
+/// 转移表：归约出非终结符后转到的状态，-1 表示不可能出现。
+constexpr Entry GOTO[STATE_COUNT][NONTERMINAL_COUNT] = {
+    {1,2,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,33,23,24,25,26,27,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,35,23,24,25,26,27,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,37,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,38,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,41,19,20,21,22,23,24,25,26,27,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,43,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,44,19,20,21,22,23,24,25,26,27,28,29,30},
+    {-1,-1,-1,-1,-1,-1,45,19,20,21,22,23,24,25,26,27,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,47,24,25,26,27,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,58,23,24,25,26,27,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,61,23,24,25,26,27,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,65,27,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,66,27,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,67,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,68,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,69,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,70,28,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,71,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,72,29,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,73,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,74,30},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+};
+
+} // namespace lalr
+
+#endif // LALRTABLES_H
@@ -0,0 +1,34 @@
+#include "lineindex.h"
+#include <algorithm>
+
+LineIndex::LineIndex(QStringView source) {
+    lineStarts.append(0);
+    // QStringView::indexOf 内部使用 SIMD 批量比较查找字符，比逐字符判断快得多
+    qsizetype pos = source.indexOf(QChar('\n'));
+    while (pos >= 0) {
+        lineStarts.append(static_cast<int>(pos + 1));
+        pos = source.indexOf(QChar('\n'), pos + 1);
+    }
+}
+
+SourceLocation LineIndex::locate(int offset) const {
+    if (lineStarts.isEmpty()) return {1, offset + 1};
+    // 找到第一个大于 offset 的行首，其前一项即为 offset 所在行
+    auto it = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+    int line = static_cast<int>(it - lineStarts.begin());
+    return {line, offset - lineStarts[line - 1] + 1};
+}
+
+int LineIndex::lineOf(int offset) const {
+    return locate(offset).line;
+}
+
+int LineIndex::offsetAt(int line, int column) const {
+    if (lineStarts.isEmpty()) return column - 1;
+    line = std::max(1, std::min(line, static_cast<int>(lineStarts.size())));
+    return lineStarts[line - 1] + column - 1;
+}
+
+int LineIndex::lineCount() const {
+    return lineStarts.isEmpty() ? 1 : lineStarts.size();
+}
@@ -0,0 +1,70 @@
+#ifndef LINEINDEX_H
+#define LINEINDEX_H
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+/**
+ * @struct SourceLocation
+ * @brief 由偏移量换算得到的行列位置，行号与列号均从 1 开始。
+ */
+struct SourceLocation {
+    int line;   ///< 行号。
+    int column; ///< 列号（以 UTF-16 码元计）。
+};
+
+/**
+ * @class LineIndex
+ * @brief 源代码的行首偏移索引，用于将 Token 偏移量按需换算为行列号。
+ *
+ * 扫描阶段只记录偏移量，不再逐字符统计行号；只有在报告诊断信息或界面需要显示
+ * 行列号时，才构建一次行首索引，并通过二分查找完成换算。
+ */
+class LineIndex {
+public:
+    /**
+     * @brief 默认构造函数，构造一个空索引（所有偏移都位于第 1 行）。
+     */
+    LineIndex() = default;
+
+    /**
+     * @brief 扫描源代码中的换行符并建立行首索引。
+     * @param source 原始源代码。
+     */
+    explicit LineIndex(QStringView source);
+
+    /**
+     * @brief 将偏移量换算为行列位置。
+     * @param offset 源代码中的偏移量（UTF-16 码元下标）。
+     * @return 对应的行列位置。
+     */
+    SourceLocation locate(int offset) const;
+
+    /**
+     * @brief 将偏移量换算为行号。
+     * @param offset 源代码中的偏移量。
+     * @return 从 1 开始的行号。
+     */
+    int lineOf(int offset) const;
+
+    /**
+     * @brief 将行列位置换算为偏移量，是 locate() 的逆运算。
+     *
+     * 行号超出范围时截断到首行或末行；列号不做检查。
+     * @param line 从 1 开始的行号。
+     * @param column 从 1 开始的列号。
+     * @return 源代码中的偏移量。
+     */
+    int offsetAt(int line, int column) const;
+
+    /**
+     * @brief 返回源代码的总行数。
+     */
+    int lineCount() const;
+
+private:
+    QVector<int> lineStarts; ///< 每一行首字符的偏移量，第 0 项恒为 0。
+};
+
+#endif // LINEINDEX_H
@@ -0,0 +1,426 @@
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QUrl>
+#include <cstdio>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "lspserver.h"
+#include "scanner.h"
+#include "parser.h"
+#include "lalrparser.h"
+#include "preprocessor.h"
+#include "arena.h"
+
+namespace {
+
+// JSON-RPC / LSP 错误码
+constexpr int PARSE_ERROR = -32700;
+constexpr int METHOD_NOT_FOUND = -32601;
+constexpr int INVALID_REQUEST = -32600;
+constexpr int REQUEST_CANCELLED = -32800;
+constexpr long long MAX_CONTENT_LENGTH = 64LL << 20; // 单条消息的最大字节数
+
+// 语义 Token 类型，下标与 initialize 中声明的 legend 一致
+enum SemanticType { SEM_KEYWORD, SEM_NUMBER, SEM_OPERATOR, SEM_VARIABLE, SEM_COMMENT, SEM_STRING };
+
+int semanticType(TokenType type) {
+    if (type >= TokenType::AUTO && type <= TokenType::_IMAGINARY) return SEM_KEYWORD;
+    if (type == TokenType::NUMBER) return SEM_NUMBER;
+    if (type == TokenType::IDENTIFIER) return SEM_VARIABLE;
+    if (type == TokenType::HEADER_NAME) return SEM_STRING;
+    if (type < TokenType::NUMBER) return SEM_OPERATOR;
+    return -1;
+}
+
+QJsonObject lspPosition(const LineIndex &lines, int offset) {
+    SourceLocation loc = lines.locate(offset);
+    return QJsonObject{{"line", loc.line - 1}, {"character", loc.column - 1}};
+}
+
+int offsetOf(const LineIndex &lines, const QJsonObject &position, int size) {
+    int offset = lines.offsetAt(position.value("line").toInt() + 1,
+                                position.value("character").toInt() + 1);
+    return qBound(0, offset, size);
+}
+
+} // namespace
+
+LspServer::LspServer(QObject *parent)
+    : QObject(parent), shutdownRequested(false)
+{
+}
+
+LspServer::~LspServer()
+{
+    for (Document &doc : documents) {
+        doc.latest->fetch_add(1);
+    }
+    pool.waitForDone();
+}
+
+void LspServer::start()
+{
+    // 读线程只负责按 Content-Length 切分消息，解析与处理都在主线程上进行
+    std::thread reader([this]() {
+        for (;;) {
+            long long length = -1;
+            int headerLines = 0;
+            std::string header;
+            while (std::getline(std::cin, header)) {
+                if (!header.empty() && header.back() == '\r') header.pop_back();
+                if (header.empty()) break;
+                ++headerLines;
+                const std::string key = "Content-Length:";
+                if (header.compare(0, key.size(), key) == 0) {
+                    bool ok = false;
+                    length = QByteArray::fromStdString(header.substr(key.size())).trimmed().toLongLong(&ok);
+                    if (!ok) length = -1;
+                }
+            }
+            if (!std::cin) break;
+            if (headerLines == 0) continue; // 消息之间多余的空行
+
+            // 长度缺失或无法解析时无从切分消息体，报告错误后从下一行重新寻找消息头；
+            // 过大的消息整体跳过
+            if (length < 0 || length > MAX_CONTENT_LENGTH) {
+                if (length > MAX_CONTENT_LENGTH) std::cin.ignore(length);
+                QMetaObject::invokeMethod(this, [this]() {
+                    sendError(QJsonValue::Null, PARSE_ERROR, "Invalid Content-Length header");
+                }, Qt::QueuedConnection);
+                if (!std::cin) break;
+                continue;
+            }
+
+            QByteArray body(static_cast<qsizetype>(length), Qt::Uninitialized);
+            std::cin.read(body.data(), length);
+            if (!std::cin) break;
+            QMetaObject::invokeMethod(this, [this, body]() { handleMessage(body); },
+                                      Qt::QueuedConnection);
+        }
+        // 标准输入关闭，客户端已退出
+        QMetaObject::invokeMethod(this, [this]() {
+            QCoreApplication::exit(shutdownRequested ? 0 : 1);
+        }, Qt::QueuedConnection);
+    });
+    reader.detach();
+}
+
+void LspServer::handleMessage(const QByteArray &body)
+{
+    const QJsonObject message = QJsonDocument::fromJson(body).object();
+    const QString method = message.value("method").toString();
+    if (method.isEmpty()) return; // 客户端对服务端请求的响应，忽略
+
+    const bool isRequest = message.contains("id");
+    const QJsonValue id = message.value("id");
+    const QJsonObject params = message.value("params").toObject();
+
+    if (method == "exit") {
+        QCoreApplication::exit(shutdownRequested ? 0 : 1);
+        return;
+    }
+    if (shutdownRequested && isRequest) {
+        sendError(id, INVALID_REQUEST, "Server is shutting down");
+        return;
+    }
+
+    if (method == "initialize") {
+        initialize(id);
+    } else if (method == "shutdown") {
+        shutdownRequested = true;
+        sendResult(id, QJsonValue::Null);
+    } else if (method == "textDocument/didOpen") {
+        didOpen(params);
+    } else if (method == "textDocument/didChange") {
+        didChange(params);
+    } else if (method == "textDocument/didClose") {
+        didClose(params);
+    } else if (method == "textDocument/semanticTokens/full") {
+        semanticTokens(id, params);
+    } else if (method == "$/cancelRequest") {
+        cancelRequest(params);
+    } else if (isRequest) {
+        sendError(id, METHOD_NOT_FOUND, QString("Unsupported method: %1").arg(method));
+    }
+}
+
+void LspServer::sendMessage(const QJsonObject &message)
+{
+    QJsonObject full = message;
+    full.insert("jsonrpc", "2.0");
+    const QByteArray body = QJsonDocument(full).toJson(QJsonDocument::Compact);
+    const QByteArray header = "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n";
+    std::fwrite(header.constData(), 1, header.size(), stdout);
+    std::fwrite(body.constData(), 1, body.size(), stdout);
+    std::fflush(stdout);
+}
+
+void LspServer::sendResult(const QJsonValue &id, const QJsonValue &result)
+{
+    sendMessage(QJsonObject{{"id", id}, {"result", result}});
+}
+
+void LspServer::sendError(const QJsonValue &id, int code, const QString &message)
+{
+    sendMessage(QJsonObject{{"id", id},
+                            {"error", QJsonObject{{"code", code}, {"message", message}}}});
+}
+
+void LspServer::initialize(const QJsonValue &id)
+{
+    const QJsonObject legend{
+        {"tokenTypes", QJsonArray{"keyword", "number", "operator", "variable", "comment", "string"}},
+        {"tokenModifiers", QJsonArray{}}
+    };
+    const QJsonObject capabilities{
+        // change = 2：增量同步
+        {"textDocumentSync", QJsonObject{{"openClose", true}, {"change", 2}}},
+        {"semanticTokensProvider", QJsonObject{{"legend", legend}, {"full", true}}}
+    };
+    sendResult(id, QJsonObject{
+        {"capabilities", capabilities},
+        {"serverInfo", QJsonObject{{"name", "CompilerPrinciple"}}}
+    });
+}
+
+void LspServer::didOpen(const QJsonObject &params)
+{
+    const QJsonObject item = params.value("textDocument").toObject();
+    const QString uri = item.value("uri").toString();
+
+    Document &doc = documents[uri];
+    doc.text = item.value("text").toString();
+    doc.lines = LineIndex(doc.text);
+    doc.version = item.value("version").toInt();
+    if (!doc.latest) doc.latest = std::make_shared<std::atomic<int>>(0);
+    analyze(uri);
+}
+
+void LspServer::didChange(const QJsonObject &params)
+{
+    const QJsonObject item = params.value("textDocument").toObject();
+    const QString uri = item.value("uri").toString();
+    auto it = documents.find(uri);
+    if (it == documents.end()) return;
+
+    Document &doc = it.value();
+    doc.version = item.value("version").toInt();
+    for (const QJsonValue &value : params.value("contentChanges").toArray()) {
+        const QJsonObject change = value.toObject();
+        const QString text = change.value("text").toString();
+        if (!change.contains("range")) {
+            doc.text = text; // 整体替换
+        } else {
+            const QJsonObject range = change.value("range").toObject();
+            const int from = offsetOf(doc.lines, range.value("start").toObject(), doc.text.size());
+            const int to = offsetOf(doc.lines, range.value("end").toObject(), doc.text.size());
+            doc.text.replace(from, qMax(0, to - from), text);
+        }
+        // 同一条通知中的后续修改基于修改后的文本定位
+        doc.lines = LineIndex(doc.text);
+    }
+    analyze(uri);
+}
+
+void LspServer::didClose(const QJsonObject &params)
+{
+    const QString uri = params.value("textDocument").toObject().value("uri").toString();
+    auto it = documents.find(uri);
+    if (it == documents.end()) return;
+
+    it.value().latest->fetch_add(1); // 作废仍在运行的分析
+    for (const QJsonValue &id : it.value().pendingSemanticRequests) {
+        sendResult(id, QJsonValue::Null);
+    }
+    documents.erase(it);
+
+    sendMessage(QJsonObject{
+        {"method", "textDocument/publishDiagnostics"},
+        {"params", QJsonObject{{"uri", uri}, {"diagnostics", QJsonArray{}}}}
+    });
+}
+
+void LspServer::semanticTokens(const QJsonValue &id, const QJsonObject &params)
+{
+    const QString uri = params.value("textDocument").toObject().value("uri").toString();
+    auto it = documents.find(uri);
+    if (it == documents.end()) {
+        sendResult(id, QJsonValue::Null);
+        return;
+    }
+
+    Document &doc = it.value();
+    if (doc.analyzed != doc.latest->load()) {
+        // 分析尚未完成，待完成后统一答复
+        doc.pendingSemanticRequests.append(id);
+        return;
+    }
+
+    QJsonArray data;
+    for (int value : doc.semanticTokens) data.append(value);
+    sendResult(id, QJsonObject{{"data", data}});
+}
+
+void LspServer::cancelRequest(const QJsonObject &params)
+{
+    const QJsonValue id = params.value("id");
+    for (Document &doc : documents) {
+        if (doc.pendingSemanticRequests.removeOne(id)) {
+            sendError(id, REQUEST_CANCELLED, "Request cancelled");
+            return;
+        }
+    }
+}
+
+void LspServer::analyze(const QString &uri)
+{
+    Document &doc = documents[uri];
+    const int generation = doc.latest->fetch_add(1) + 1;
+    const QString text = doc.text;
+    const int version = doc.version;
+    const std::shared_ptr<std::atomic<int>> latest = doc.latest;
+
+    pool.start([this, uri, text, generation, version, latest]() {
+        Analysis analysis;
+        if (!runAnalysis(uri, text, generation, latest, analysis)) return;
+        QMetaObject::invokeMethod(this, [this, uri, generation, version, analysis]() {
+            analysisFinished(uri, generation, version, analysis);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void LspServer::analysisFinished(const QString &uri, int generation, int version,
+                                 const Analysis &analysis)
+{
+    auto it = documents.find(uri);
+    if (it == documents.end()) return;
+    Document &doc = it.value();
+    if (generation != doc.latest->load()) return; // 文档已再次修改，结果过期
+
+    doc.analyzed = generation;
+    doc.semanticTokens = analysis.semanticTokens;
+
+    sendMessage(QJsonObject{
+        {"method", "textDocument/publishDiagnostics"},
+        {"params", QJsonObject{{"uri", uri}, {"version", version},
+                               {"diagnostics", analysis.diagnostics}}}
+    });
+
+    if (doc.pendingSemanticRequests.isEmpty()) return;
+    QJsonArray data;
+    for (int value : doc.semanticTokens) data.append(value);
+    const QJsonObject result{{"data", data}};
+    for (const QJsonValue &id : doc.pendingSemanticRequests) {
+        sendResult(id, result);
+    }
+    doc.pendingSemanticRequests.clear();
+}
+
+bool LspServer::runAnalysis(const QString &uri, const QString &text, int generation,
+                            const std::shared_ptr<std::atomic<int>> &latest, Analysis &analysis)
+{
+    auto stale = [&]() { return latest->load() != generation; };
+
+    Scanner scanner(text);
+    scanner.setWarningsEnabled(false);
+    scanner.setRecordComments(true);
+    const QVector<Token> tokens = scanner.scanTokens();
+    const QVector<CommentRange> &comments = scanner.comments();
+    const LineIndex lines(text);
+    if (stale()) return false;
+
+    // 语义 Token：按偏移量合并 Token 与注释，注释按行拆开，使用 LSP 的相对编码
+    QVector<int> &data = analysis.semanticTokens;
+    data.reserve(tokens.size() * 5);
+    int prevLine = 0;
+    int prevChar = 0;
+    auto push = [&](int offset, int length, int type) {
+        SourceLocation loc = lines.locate(offset);
+        const int line = loc.line - 1;
+        const int character = loc.column - 1;
+        data << line - prevLine << (line == prevLine ? character - prevChar : character)
+             << length << type << 0;
+        prevLine = line;
+        prevChar = character;
+    };
+    int c = 0;
+    for (const Token &token : tokens) {
+        for (; c < comments.size() && comments[c].offset < token.offset; ++c) {
+            const int end = comments[c].offset + comments[c].length;
+            int from = comments[c].offset;
+            while (from < end) {
+                const int line = lines.lineOf(from);
+                const int lineEnd = line < lines.lineCount() ? lines.offsetAt(line + 1, 1) - 1 : end;
+                const int to = qMin(end, lineEnd);
+                if (to > from) push(from, to - from, SEM_COMMENT);
+                from = lineEnd + 1;
+            }
+        }
+        const int type = semanticType(token.type);
+        if (type >= 0) push(token.offset, token.value.size(), type);
+    }
+
+    // 预处理：file:// 文档按其所在目录查找头文件，高亮仍使用预处理前的 Token
+    const QString path = QUrl(uri).toLocalFile();
+    Preprocessor preprocessor(path);
+    if (!path.isEmpty()) preprocessor.setIncludePaths({QFileInfo(path).absolutePath()});
+    const QVector<Token> expanded = preprocessor.process(text, tokens);
+    if (stale()) return false;
+
+    for (const PreprocessorError &e : preprocessor.errors()) {
+        analysis.diagnostics.append(QJsonObject{
+            {"range", QJsonObject{{"start", lspPosition(lines, e.offset)},
+                                  {"end", lspPosition(lines, e.offset)}}},
+            {"severity", 1},
+            {"source", "CompilerPrinciple"},
+            {"message", e.message}
+        });
+    }
+
+    // 每个工作线程复用自己的会话内存池
+    thread_local CompileArena arena;
+    arena.reset(text.size());
+    Parser parser(expanded, &lines, arena.resource());
+    parser.setConsoleOutput(false);
+    parser.setSemanticChecks(true);
+    // 文档再次修改后在下一个顶层声明处停下，不再把过期的分析做完
+    parser.setCancelCheck(stale);
+    parser.parseParallel();
+    // 被取消的分析结果不完整，也不必再启动 LALR 重新分析
+    if (stale()) return false;
+
+    // 嵌套过深时递归下降分析器会放弃，改用不递归的 LALR 分析器重新分析
+    std::optional<LalrParser> fallback;
+    if (parser.nestingExceeded()) {
+        fallback.emplace(expanded, &lines, arena.resource());
+        fallback->setConsoleOutput(false);
+        fallback->setSemanticChecks(true);
+        fallback->parse();
+        if (stale()) return false;
+    }
+
+    const DiagnosticBuffer &diags = fallback ? fallback->diagnostics() : parser.diagnostics();
+    for (int i = 0; i < diags.size(); ++i) {
+        const Diagnostic &d = diags.at(i);
+        const Token &token = expanded[d.tokenIndex];
+        QString message = diagnosticMessage(d.code);
+        if (!d.expected.isEmpty()) {
+            QStringList names;
+            for (TokenType type : d.expected.toList()) names.append(getTokenTypeString(type));
+            message += QString("，期望: %1").arg(names.join(", "));
+        }
+        analysis.diagnostics.append(QJsonObject{
+            {"range", QJsonObject{{"start", lspPosition(lines, token.offset)},
+                                  {"end", lspPosition(lines, token.offset + token.value.size())}}},
+            {"severity", 1},
+            {"code", static_cast<int>(d.code)},
+            {"source", "CompilerPrinciple"},
+            {"message", message}
+        });
+    }
+    return true;
+}
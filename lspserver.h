@@ -0,0 +1,98 @@
+#ifndef LSPSERVER_H
+#define LSPSERVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include "lineindex.h"
+
+/**
+ * @class LspServer
+ * @brief 通过标准输入输出提供 Language Server Protocol 服务的常驻进程。
+ *
+ * 每个打开的文档在内存中保存源码、行首索引以及最近一次分析得到的诊断和语义 Token，
+ * 编辑器的每次检查都直接使用这些常驻状态，不必重新启动进程。文档修改后在线程池上
+ * 重新扫描和语法分析；同一文档的新修改会使尚未完成的旧分析作废。
+ *
+ * 支持的请求与通知：initialize、shutdown、exit、textDocument/didOpen、
+ * textDocument/didChange（增量同步）、textDocument/didClose、
+ * textDocument/semanticTokens/full 以及 $/cancelRequest。
+ */
+class LspServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LspServer(QObject *parent = nullptr);
+    ~LspServer();
+
+    /**
+     * @brief 启动读取标准输入的线程，开始处理消息。
+     */
+    void start();
+
+private:
+    /**
+     * @brief 一次分析的结果，在工作线程上生成。
+     */
+    struct Analysis {
+        QJsonArray diagnostics;      ///< LSP 格式的诊断信息。
+        QVector<int> semanticTokens; ///< LSP 相对编码的语义 Token 数据。
+    };
+
+    /**
+     * @brief 一个打开文档的常驻状态。
+     */
+    struct Document {
+        QString text;                               ///< 当前源码。
+        LineIndex lines;                            ///< 当前源码的行首索引。
+        int version = 0;                            ///< 编辑器给出的版本号。
+        std::shared_ptr<std::atomic<int>> latest;   ///< 最新一次分析的代号，供工作线程判断是否过期。
+        int analyzed = 0;                           ///< 已完成分析的代号。
+        QVector<int> semanticTokens;                ///< 最近一次分析的语义 Token。
+        QList<QJsonValue> pendingSemanticRequests;  ///< 等待分析完成的语义 Token 请求。
+    };
+
+    void handleMessage(const QByteArray &body);
+    void sendMessage(const QJsonObject &message);
+    void sendResult(const QJsonValue &id, const QJsonValue &result);
+    void sendError(const QJsonValue &id, int code, const QString &message);
+
+    void initialize(const QJsonValue &id);
+    void didOpen(const QJsonObject &params);
+    void didChange(const QJsonObject &params);
+    void didClose(const QJsonObject &params);
+    void semanticTokens(const QJsonValue &id, const QJsonObject &params);
+    void cancelRequest(const QJsonObject &params);
+
+    /**
+     * @brief 为文档启动一次后台分析，使该文档之前未完成的分析作废。
+     */
+    void analyze(const QString &uri);
+
+    /**
+     * @brief 分析完成后在主线程上更新文档状态并发布结果；过期的结果直接丢弃。
+     */
+    void analysisFinished(const QString &uri, int generation, int version, const Analysis &analysis);
+
+    /**
+     * @brief 在工作线程上扫描、预处理并分析源码。
+     * @param uri 文档的 URI，file:// 文档所在目录用于查找头文件。
+     * @param latest 文档最新的分析代号，变化时提前结束。
+     * @return 分析被作废时返回 false。
+     */
+    static bool runAnalysis(const QString &uri, const QString &text, int generation,
+                            const std::shared_ptr<std::atomic<int>> &latest, Analysis &analysis);
+
+    QHash<QString, Document> documents; ///< 所有打开的文档，键为 URI。
+    QThreadPool pool;                   ///< 分析任务使用的线程池。
+    bool shutdownRequested;             ///< 是否已收到 shutdown 请求。
+};
+
+#endif // LSPSERVER_H
@@ -1,14 +1,155 @@
 #include <QApplication>  // 注意这里要包含 QApplication 的头文件
+#include <QCoreApplication>
+#include <cstring>
 
 #include "scanner.h"
 #include "parser.h"
 #include "mainwindow.h"
+#include "lspserver.h"
+#include "benchmark.h"
+#include "parsercheck.h"
+#include "scannercheck.h"
+#include "dfascanner.h"
+#include "irfile.h"
+#include "lalrparser.h"
+#include "preprocessor.h"
+#include "sourcetext.h"
+#include "arena.h"
+#include <QFileInfo>
+#include <QTextStream>
+#include <QTimer>
+
+namespace {
+
+// --emit-ir <源文件> <输出文件> [--jsonl]：把预处理后的 Token 流与四元式写成 .cpir 或 JSON Lines，
+// 输出文件为 "-" 时写到标准输出。有错误时照常写出 Token，但不写四元式
+int emitIr(const QStringList &arguments)
+{
+    QTextStream err(stderr);
+    if (arguments.size() < 2) {
+        err << "用法：--emit-ir <源文件> <输出文件> [--jsonl]\n";
+        return 2;
+    }
+    const QString path = arguments[0];
+    QString text;
+    if (!readSourceText(path, text)) {
+        err << path << ": 无法读取文件\n";
+        return 2;
+    }
+
+    // 一次扫描整个文件，不需要分块与注释范围，使用表驱动的 DfaScanner
+    DfaScanner scanner(text);
+    scanner.setWarningsEnabled(false);
+    Preprocessor preprocessor(path);
+    preprocessor.setIncludePaths({QFileInfo(path).absolutePath()});
+    const QVector<Token> tokens = preprocessor.process(text, scanner.scanTokens());
+
+    IrWriter writer(arguments.contains("--jsonl") ? IrWriter::Format::JsonLines : IrWriter::Format::Binary);
+    if (!writer.open(arguments[1])) {
+        err << arguments[1] << ": " << writer.errorString() << "\n";
+        return 2;
+    }
+    writer.writeTokens(tokens);
+
+    const LineIndex lines(text);
+    CompileArena arena;
+    QuadBuilder quads;
+    LalrParser parser(tokens, &lines, arena.resource());
+    parser.setConsoleOutput(false);
+    parser.setQuadBuilder(&quads);
+    parser.setSemanticChecks(true);
+    const bool ok = parser.parse() && preprocessor.errors().isEmpty();
+    if (ok) writer.writeQuads(quads.quads());
+    for (const PreprocessorError &e : preprocessor.errors()) {
+        err << path << ":" << lines.lineOf(e.offset) << ": " << e.message << "\n";
+    }
+    for (const QString &message : parser.diagnostics().formatAll(tokens, &lines)) {
+        err << path << ": " << message << "\n";
+    }
+
+    if (!writer.close()) {
+        err << arguments[1] << ": " << writer.errorString() << "\n";
+        return 2;
+    }
+    return ok ? 0 : 1;
+}
+
+// --dump-ir <文件>：把 .cpir 文件按 JSON Lines 输出到标准输出
+int dumpIr(const QStringList &arguments)
+{
+    QTextStream err(stderr);
+    if (arguments.isEmpty()) {
+        err << "用法：--dump-ir <.cpir 文件>\n";
+        return 2;
+    }
+    IrReader reader;
+    if (!reader.open(arguments[0])) {
+        err << arguments[0] << ": " << reader.errorString() << "\n";
+        return 2;
+    }
+    IrWriter writer(IrWriter::Format::JsonLines);
+    if (!writer.open("-")) return 2;
+    for (qsizetype i = 0; i < reader.tokenCount(); ++i) writer.writeToken(reader.token(i));
+    for (qsizetype i = 0; i < reader.quadCount(); ++i) writer.writeQuad(reader.quad(i));
+    if (!writer.close()) return 2;
+    if (!reader.isComplete()) {
+        err << arguments[0] << ": 文件不完整，只输出了已完整写入的部分\n";
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
 
 int main(int argc, char *argv[])
 {
+    // --lsp：不创建窗口，作为语言服务器通过标准输入输出与编辑器通信
+    if (argc > 1 && std::strcmp(argv[1], "--lsp") == 0) {
+        QCoreApplication app(argc, argv);
+        LspServer server;
+        server.start();
+        return app.exec();
+    }
+
+    // --check-parsers：对给定源文件或随机程序比较递归下降与 LALR 两个分析器的结果
+    if (argc > 1 && std::strcmp(argv[1], "--check-parsers") == 0) {
+        QCoreApplication app(argc, argv);
+        ParserCheck check(app.arguments().mid(2));
+        return check.run();
+    }
+
+    // --check-scanners：对给定源文件或随机源代码比较 Scanner 与 DfaScanner 的 Token 序列
+    if (argc > 1 && std::strcmp(argv[1], "--check-scanners") == 0) {
+        QCoreApplication app(argc, argv);
+        ScannerCheck check(app.arguments().mid(2));
+        return check.run();
+    }
+
+    // --emit-ir / --dump-ir：写出或查看编译结果的二进制格式，供下游分析工具使用
+    if (argc > 1 && std::strcmp(argv[1], "--emit-ir") == 0) {
+        QCoreApplication app(argc, argv);
+        return emitIr(app.arguments().mid(2));
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--dump-ir") == 0) {
+        QCoreApplication app(argc, argv);
+        return dumpIr(app.arguments().mid(2));
+    }
+
+    // --benchmark：无头运行界面延迟基准测试，未指定平台插件时使用 offscreen
+    const bool benchmark = argc > 1 && std::strcmp(argv[1], "--benchmark") == 0;
+    if (benchmark && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication app(argc, argv);  // 修改为 QApplication
     MainWindow win;
     win.show();
 
+    if (benchmark) {
+        LatencyBenchmark bench(&win, app.arguments());
+        QTimer::singleShot(0, &app, [&]() { app.exit(bench.run()); });
+        return app.exec();
+    }
+
     return app.exec();
 }
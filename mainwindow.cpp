@@ -1,90 +1,356 @@
-#include <QtConcurrent/QtConcurrentRun>
-#include <QFutureWatcher>
-
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
-#include "scanner.h"
+#include "highlighter.h"
+#include "sourcetext.h"
+#include "tokentablemodel.h"
+#include <QDir>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QMenuBar>
+#include <QMessageBox>
+#include <QPair>
+#include <QPointer>
+#include <QTextCursor>
+#include <QtConcurrent>
+
+namespace {
+
+// 超过该字符数的文档不在界面线程上逐块扫描高亮，改为等待后台扫描结果
+constexpr int LARGE_DOCUMENT_CHARS = 1 << 20;
+
+// 大文件编辑停顿多久后才重新编译（毫秒），连续输入时不必每个按键都重新扫描整个文件
+constexpr int LARGE_COMPILE_DELAY_MS = 300;
+
+// 载入文件时每次插入编辑器的字符数，每块之间回到事件循环
+constexpr int LOAD_CHUNK_CHARS = 1 << 18;
+
+} // namespace
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , untitledCount(0)
 {
     ui->setupUi(this);
-    futureWatcher = new QFutureWatcher<QVector<Token>>(this);
 
 
     ui->splitter->setStretchFactor(0,70);
     ui->splitter->setStretchFactor(1,40);
 
-    ui->codeTextEdit->setLineWrapMode(QTextEdit::NoWrap);
-    ui->codeTextEdit->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    // 设置所有列自动拉伸；行高固定，百万行的表也无需逐行计算高度
+    ui->scannerTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    ui->scannerTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
 
-       // 初始化表格
-    ui->scannerTableWidget->setColumnCount(4);
-    QStringList headers = {"Type (Int)", "Type (Name)", "Value", "Line"};
-    ui->scannerTableWidget->setHorizontalHeaderLabels(headers);
-
-    // 设置所有列自动拉伸
-    for(int col = 0; col < ui->scannerTableWidget->columnCount(); ++col){
-        ui->scannerTableWidget->horizontalHeader()->setSectionResizeMode(col, QHeaderView::Stretch);
-    }
+    // 文件菜单
+    QMenu *fileMenu = menuBar()->addMenu("文件");
+    QAction *newAction = fileMenu->addAction("新建");
+    newAction->setShortcut(QKeySequence::New);
+    connect(newAction, &QAction::triggered, this, &MainWindow::newDocument);
+    QAction *openAction = fileMenu->addAction("打开...");
+    openAction->setShortcut(QKeySequence::Open);
+    connect(openAction, &QAction::triggered, this, &MainWindow::openDocuments);
+    QAction *closeAction = fileMenu->addAction("关闭");
+    closeAction->setShortcut(QKeySequence::Close);
+    connect(closeAction, &QAction::triggered, this, [this]() {
+        closeDocument(ui->documentTabWidget->currentIndex());
+    });
 
+    connect(ui->documentTabWidget, &QTabWidget::tabCloseRequested, this, &MainWindow::closeDocument);
+    connect(ui->documentTabWidget, &QTabWidget::currentChanged,
+            this, &MainWindow::onCurrentDocumentChanged);
 
-     connect(futureWatcher, &QFutureWatcher<QVector<Token>>::finished, this, &MainWindow::onTokensReady);
+    newDocument();
 }
 
 MainWindow::~MainWindow()
 {
+    // 流水线须在调度器之前析构
+    ui->documentTabWidget->blockSignals(true);
+    while (!documents.isEmpty()) {
+        closeDocument(0);
+    }
+    // 退役的流水线可能还在等待任务退出，在此同步析构，不留给事件循环
+    qDeleteAll(findChildren<CompilePipeline *>(QString(), Qt::FindDirectChildrenOnly));
     delete ui;
 }
 
+void MainWindow::newDocument()
+{
+    addDocument(QString());
+}
 
-void MainWindow::on_codeTextEdit_textChanged()
+void MainWindow::openDocuments()
 {
-    QString text = ui->codeTextEdit->toPlainText();
-    // 开始异步扫描
-    QFuture<QVector<Token>> future = QtConcurrent::run([text]() {
-        Scanner scanner(text);
-        return scanner.scanTokens();
+    const QStringList paths = QFileDialog::getOpenFileNames(this, "打开", QDir::currentPath());
+    for (const QString &path : paths) {
+        addDocument(QFileInfo(path).absoluteFilePath());
+    }
+}
+
+Document *MainWindow::addDocument(const QString &path)
+{
+    Document *doc = new Document;
+    doc->path = path;
+    doc->editor = new QPlainTextEdit;
+    doc->editor->setLineWrapMode(QPlainTextEdit::NoWrap);
+    doc->editor->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    doc->highlighter = new CodeHighlighter(doc->editor->document());
+    doc->tokenModel = new TokenTableModel(doc->editor);
+    doc->compileTimer = new QTimer(doc->editor);
+    doc->compileTimer->setSingleShot(true);
+    doc->compileTimer->setInterval(LARGE_COMPILE_DELAY_MS);
+    connect(doc->compileTimer, &QTimer::timeout, this, [this, doc]() { startCompile(doc); });
+
+    // 头文件先在文档所在目录查找，再在工作目录查找
+    doc->pipeline = new CompilePipeline(&scheduler, this);
+    QStringList includePaths;
+    if (!path.isEmpty()) includePaths.append(QFileInfo(path).absolutePath());
+    includePaths.append(QDir::currentPath());
+    doc->pipeline->setIncludePaths(includePaths);
+
+    // 以编辑器为接收者：文档关闭后，尚未送达的结果随编辑器一起丢弃
+    connect(doc->pipeline, &CompilePipeline::scanStarted, doc->editor,
+            [this, doc](int generation, const LineIndex &lines) {
+        onScanStarted(doc, generation, lines);
+    });
+    connect(doc->pipeline, &CompilePipeline::tokensReady, doc->editor,
+            [this, doc](int generation, int firstRow, const QVector<Token> &tokens) {
+        onTokensReady(doc, generation, firstRow, tokens);
+    });
+    connect(doc->pipeline, &CompilePipeline::scanFinished, doc->editor,
+            [this, doc](int generation, const ScanResult &result) {
+        onScanFinished(doc, generation, result);
+    });
+    connect(doc->pipeline, &CompilePipeline::diagnosticsReady, doc->editor,
+            [this, doc](int generation, const QStringList &messages) {
+        onDiagnosticsReady(doc, generation, messages);
+    });
+    connect(doc->pipeline, &CompilePipeline::quadsReady, doc->editor,
+            [this, doc](int generation, const QStringList &quads) {
+        onQuadsReady(doc, generation, quads);
+    });
+    connect(doc->editor->document(), &QTextDocument::contentsChange, this,
+            [this, doc](int position, int charsRemoved, int charsAdded) {
+        syncText(doc, position, charsRemoved, charsAdded);
+    });
+    connect(doc->editor, &QPlainTextEdit::textChanged, this, [this, doc]() { documentChanged(doc); });
+
+    documents.append(doc);
+    const QString title = path.isEmpty() ? QString("未命名 %1").arg(++untitledCount)
+                                         : QFileInfo(path).fileName();
+    const int index = ui->documentTabWidget->addTab(doc->editor, title);
+    ui->documentTabWidget->setTabToolTip(index, path);
+    ui->documentTabWidget->setCurrentIndex(index);
+
+    if (path.isEmpty()) {
+        startCompile(doc);
+        return doc;
+    }
+
+    // 读取与解码在后台线程上进行；文档关闭后监视器随编辑器析构，结果被丢弃
+    doc->loadedChars = 0;
+    doc->editor->setReadOnly(true);
+    auto *watcher = new QFutureWatcher<QPair<bool, QString>>(doc->editor);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, doc, watcher]() {
+        const QPair<bool, QString> result = watcher->result();
+        watcher->deleteLater();
+        // 监视器是编辑器的子对象，处理结果可能关闭文档，须等它的信号发射结束后再进行
+        QMetaObject::invokeMethod(doc->editor, [this, doc, result]() {
+            onFileLoaded(doc, result.first, result.second);
+        }, Qt::QueuedConnection);
     });
+    watcher->setFuture(QtConcurrent::run([path]() {
+        QString text;
+        const bool ok = readSourceText(path, text);
+        return qMakePair(ok, text);
+    }));
+    return doc;
+}
+
+void MainWindow::onFileLoaded(Document *doc, bool ok, const QString &text)
+{
+    if (!ok) {
+        // 提示框运行嵌套的事件循环，期间文档可能已被用户关闭
+        const QPointer<QPlainTextEdit> editor = doc->editor;
+        QMessageBox::warning(this, "打开", QString("无法打开文件 %1").arg(doc->path));
+        if (editor) closeDocument(ui->documentTabWidget->indexOf(editor));
+        return;
+    }
+    doc->text = text;
+    doc->highlighter->setDeferred(text.size() > LARGE_DOCUMENT_CHARS);
+    // 载入过程不进入撤销栈
+    doc->editor->document()->setUndoRedoEnabled(false);
+    loadNextChunk(doc);
+}
+
+void MainWindow::loadNextChunk(Document *doc)
+{
+    const int size = doc->text.size();
+    int end = qMin(size, doc->loadedChars + LOAD_CHUNK_CHARS);
+    // 不在代理对中间切开
+    if (end < size && doc->text.at(end - 1).isHighSurrogate()) ++end;
+    if (end > doc->loadedChars) {
+        QTextCursor cursor(doc->editor->document());
+        cursor.movePosition(QTextCursor::End);
+        cursor.insertText(doc->text.mid(doc->loadedChars, end - doc->loadedChars));
+        doc->loadedChars = end;
+    }
+    if (doc->loadedChars < size) {
+        QMetaObject::invokeMethod(doc->editor, [this, doc]() { loadNextChunk(doc); },
+                                  Qt::QueuedConnection);
+        return;
+    }
 
-    // 使用 QFutureWatcher 监听 future 的完成状态
-    futureWatcher->setFuture(future);
+    doc->loadedChars = -1;
+    doc->length = size;
+    doc->pipeline->setText(doc->text);
+    doc->text.clear();
+    doc->editor->document()->setUndoRedoEnabled(true);
+    doc->editor->setReadOnly(false);
+    doc->editor->moveCursor(QTextCursor::Start);
+    startCompile(doc);
+}
 
-//    ui->pa
+void MainWindow::closeDocument(int index)
+{
+    QWidget *editor = ui->documentTabWidget->widget(index);
+    if (editor == nullptr) return;
+    for (int i = 0; i < documents.size(); ++i) {
+        Document *doc = documents[i];
+        if (doc->editor != editor) continue;
+        documents.removeAt(i);
+        // 流水线取消任务并断开信号后由调度器在任务退出时删除，界面线程不等待
+        doc->pipeline->retire();
+        ui->documentTabWidget->removeTab(index);
+        delete doc->editor;
+        delete doc;
+        break;
+    }
 }
-void MainWindow::onTokensReady()
+
+Document *MainWindow::currentDocument() const
 {
-    auto tokens = futureWatcher->result();
+    QWidget *editor = ui->documentTabWidget->currentWidget();
+    for (Document *doc : documents) {
+        if (doc->editor == editor) return doc;
+    }
+    return nullptr;
+}
 
-    // 清空表格
-    ui->scannerTableWidget->clearContents();
-    ui->scannerTableWidget->setRowCount(0);
+void MainWindow::onCurrentDocumentChanged(int index)
+{
+    Q_UNUSED(index);
+    Document *doc = currentDocument();
+    scheduler.setFocused(doc ? doc->pipeline : nullptr);
+    showDocument(doc);
+}
 
-    // 设置行数
-    ui->scannerTableWidget->setRowCount(tokens.size());
+void MainWindow::syncText(Document *doc, int position, int charsRemoved, int charsAdded)
+{
+    if (doc->loadedChars >= 0) return; // 载入中，载入完成后整体交给流水线
 
-    for (int i = 0; i < tokens.size(); ++i) {
-        const Token &token = tokens[i];
+    // 整体替换内容时 Qt 报告的范围会多算末尾的段落分隔符，先截到实际长度
+    QTextDocument *document = doc->editor->document();
+    const int length = document->characterCount() - 1;
+    charsRemoved = qMin(charsRemoved, doc->length - position);
+    charsAdded = qMin(charsAdded, length - position);
+    if (position < 0 || charsRemoved < 0 || charsAdded < 0
+        || doc->length - charsRemoved + charsAdded != length) {
+        doc->length = length;
+        doc->pipeline->setText(doc->editor->toPlainText()); // 范围对不上时整体同步一次
+        return;
+    }
 
-        // 插入枚举整数值（第0列）
-        QTableWidgetItem *typeItem = new QTableWidgetItem(QString::number(static_cast<int>(token.type)));
-        typeItem->setTextAlignment(Qt::AlignCenter); // 设置文本居中
-        ui->scannerTableWidget->setItem(i, 0, typeItem);
+    QTextCursor cursor(document);
+    cursor.setPosition(position);
+    cursor.setPosition(position + charsAdded, QTextCursor::KeepAnchor);
+    QString added = cursor.selectedText();
+    added.replace(QChar::ParagraphSeparator, QChar('\n'));
+    doc->length = length;
+    doc->pipeline->edit(position, charsRemoved, added);
+}
 
-        // 插入类型字符串（第1列）
-        QTableWidgetItem *typeNameItem = new QTableWidgetItem(getTokenTypeString(token.type));
-        typeNameItem->setTextAlignment(Qt::AlignCenter); // 设置文本居中
-        ui->scannerTableWidget->setItem(i, 1, typeNameItem);
+void MainWindow::documentChanged(Document *doc)
+{
+    if (doc->loadedChars >= 0) return;
+    const bool large = doc->length > LARGE_DOCUMENT_CHARS;
+    doc->highlighter->setDeferred(large);
+    if (large) {
+        doc->compileTimer->start();
+    } else {
+        startCompile(doc);
+    }
+}
+
+void MainWindow::startCompile(Document *doc)
+{
+    doc->compileTimer->stop();
 
-        // 插入值（第2列）
-        QTableWidgetItem *valueItem = new QTableWidgetItem(token.value);
-        valueItem->setTextAlignment(Qt::AlignCenter); // 设置文本居中
-        ui->scannerTableWidget->setItem(i, 2, valueItem);
+    // 启动新一代流水线，上一代的结果随之作废
+    doc->scanRevision = doc->editor->document()->revision();
+    doc->generation = doc->pipeline->start();
 
-        // 插入行号（第3列）
-        QTableWidgetItem *lineItem = new QTableWidgetItem(QString::number(token.line));
-        lineItem->setTextAlignment(Qt::AlignCenter); // 设置文本居中
-        ui->scannerTableWidget->setItem(i, 3, lineItem);
+    // 清空上一次的结果，新结果按块陆续到达
+    doc->tokenModel->reset(LineIndex());
+    doc->messages.clear();
+    doc->quads.clear();
+    if (doc == currentDocument()) {
+        ui->parserTextEdit->clear();
+        ui->irTextEdit->clear();
     }
 }
+
+void MainWindow::showDocument(const Document *doc)
+{
+    // 每个文档有自己的模型，切换时只换模型，不重新填表
+    QItemSelectionModel *selection = ui->scannerTableView->selectionModel();
+    ui->scannerTableView->setModel(doc ? doc->tokenModel : nullptr);
+    delete selection;
+
+    ui->parserTextEdit->clear();
+    ui->irTextEdit->clear();
+    if (doc == nullptr) return;
+    ui->parserTextEdit->setPlainText(doc->messages.join("\n"));
+    ui->irTextEdit->setPlainText(doc->quads.join("\n"));
+}
+
+void MainWindow::onScanStarted(Document *doc, int generation, const LineIndex &lines)
+{
+    if (generation != doc->generation) return; // 过期结果
+    doc->tokenModel->reset(lines);
+}
+
+void MainWindow::onTokensReady(Document *doc, int generation, int firstRow, const QVector<Token> &tokens)
+{
+    if (generation != doc->generation) return;
+    // 只有前台文档逐块发布；中途切换过来的文档不衔接，等完整扫描结果到达后一次换上
+    doc->tokenModel->appendTokens(firstRow, tokens);
+}
+
+void MainWindow::onScanFinished(Document *doc, int generation, const ScanResult &result)
+{
+    if (generation != doc->generation) return;
+    // 高亮器与 Token 表共用同一份扫描结果
+    doc->tokenModel->setScan(result);
+    doc->highlighter->setSharedTokens(result, doc->scanRevision);
+}
+
+void MainWindow::onDiagnosticsReady(Document *doc, int generation, const QStringList &messages)
+{
+    if (generation != doc->generation) return;
+    doc->messages.append(messages);
+    if (doc != currentDocument()) return;
+    // 按纯文本追加，错误信息中的 '<' 等字符不会被当作富文本
+    QTextCursor cursor(ui->parserTextEdit->document());
+    cursor.movePosition(QTextCursor::End);
+    if (doc->messages.size() > messages.size()) cursor.insertText("\n");
+    cursor.insertText(messages.join("\n"));
+}
+
+void MainWindow::onQuadsReady(Document *doc, int generation, const QStringList &quads)
+{
+    if (generation != doc->generation) return;
+    doc->quads.append(quads);
+    if (doc == currentDocument()) ui->irTextEdit->appendPlainText(quads.join("\n"));
+}
@@ -2,14 +2,47 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QtConcurrent/QtConcurrentRun>
-#include <QFutureWatcher>
+#include <QPlainTextEdit>
+#include <QTimer>
 #include "token.h"
+#include "lineindex.h"
+#include "pipeline.h"
+#include "scheduler.h"
+
+class CodeHighlighter;
+class TokenTableModel;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
 
+/**
+ * @brief 一个打开的文档及其独立的编译状态。
+ *
+ * 每个文档有自己的编辑器、增量高亮器和编译流水线；后台文档的最新结果保存在这里，
+ * 切换标签页时直接显示，不必重新编译。
+ *
+ * 每次编辑只把修改范围与插入的文本记录到流水线（见 CompilePipeline::edit()），
+ * 源代码的副本由流水线在工作线程上维护，界面线程既不调用 toPlainText()，也不复制
+ * 整个文档。从文件打开时，text 由后台线程从映射的文件解码得到，分块插入编辑器后
+ * 交给流水线并释放。
+ */
+struct Document {
+    QPlainTextEdit *editor = nullptr;       ///< 编辑器，同时作为流水线信号的接收者。
+    CodeHighlighter *highlighter = nullptr; ///< 增量语法高亮器。
+    CompilePipeline *pipeline = nullptr;    ///< 本文档的编译流水线。
+    TokenTableModel *tokenModel = nullptr;  ///< 词法分析结果表的模型。
+    QTimer *compileTimer = nullptr;         ///< 大文件编辑后延迟启动编译的定时器。
+    QString path;                           ///< 文件路径，新建的文档为空。
+    QString text;                           ///< 正在分块载入的文件内容，载入完成后清空。
+    int length = 0;                         ///< 编辑器内容的字符数。
+    int loadedChars = -1;                   ///< 分块载入时已插入编辑器的字符数，-1 表示不在载入中。
+    int generation = 0;                     ///< 最新一代任务的代号。
+    int scanRevision = -1;                  ///< 最新任务开始时文档的修订号。
+    QStringList messages;                   ///< 最新的语法分析结果。
+    QStringList quads;                      ///< 最新的四元式。
+};
+
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -19,12 +52,59 @@ public:
     ~MainWindow();
 
 private slots:
-    void on_codeTextEdit_textChanged();
-    void onTokensReady();
+    void newDocument();
+    void openDocuments();
+    void closeDocument(int index);
+    void onCurrentDocumentChanged(int index);
 
 private:
+    /**
+     * @brief 新建一个标签页。
+     * @param path 文件路径，为空时表示未命名文档；否则在后台读取文件后分块载入。
+     */
+    Document *addDocument(const QString &path);
+
+    /**
+     * @brief 后台读取文件完成。
+     */
+    void onFileLoaded(Document *doc, bool ok, const QString &text);
+
+    /**
+     * @brief 向编辑器插入下一块已读取的文本，全部插入后启动编译。
+     */
+    void loadNextChunk(Document *doc);
+
+    /**
+     * @brief 把编辑器报告的修改范围与插入的文本记录到流水线。
+     */
+    void syncText(Document *doc, int position, int charsRemoved, int charsAdded);
+
+    /**
+     * @brief 把已记录的编辑交给流水线，启动一次编译。
+     */
+    void startCompile(Document *doc);
+
+    /**
+     * @brief 返回当前标签页的文档，没有时返回空指针。
+     */
+    Document *currentDocument() const;
+
+    void documentChanged(Document *doc);
+    void onScanStarted(Document *doc, int generation, const LineIndex &lines);
+    void onTokensReady(Document *doc, int generation, int firstRow, const QVector<Token> &tokens);
+    void onScanFinished(Document *doc, int generation, const ScanResult &result);
+    void onDiagnosticsReady(Document *doc, int generation, const QStringList &messages);
+    void onQuadsReady(Document *doc, int generation, const QStringList &quads);
+
+    /**
+     * @brief 把文档保存的结果显示到结果面板。
+     */
+    void showDocument(const Document *doc);
+
     Ui::MainWindow *ui;
-    QFutureWatcher<QVector<Token>> *futureWatcher;
 
+    CompileScheduler scheduler;    ///< 所有文档共用的后台调度器。
+    QVector<Document *> documents; ///< 所有打开的文档。
+    int untitledCount;             ///< 已创建的未命名文档数，用于命名。
 };
 #endif // MAINWINDOW_H
@@ -1,20 +1,219 @@
 #include "parser.h"
 #include <QDebug>
-
-Parser::Parser(const QVector<Token>& tokens)
-    : tokens(tokens), current(0), hadError(false) {}
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <cstddef>
+
+Parser::Parser(const QVector<Token>& tokens, const LineIndex* lines,
+               std::pmr::memory_resource* memory)
+    : tokens(tokens), lines(lines), memory(memory), ownStructure(tokens, memory),
+      structure(&ownStructure), skipFunctionBodies(false), current(0),
+      end(std::max(0, int(tokens.size()) - 1)), diags(), ir(nullptr), places(memory),
+      consoleOutput(true), semanticChecks(false), symbols(memory), types(memory),
+      returnType(TokenType::INT), nesting(0), tooDeep(false), pool(nullptr),
+      hadError(false) {}
+
+Parser::Parser(const QVector<Token>& tokens, const LineIndex* lines,
+               const StructuralIndex* structure, int begin, int end, int maxErrors,
+               std::pmr::memory_resource* memory)
+    : tokens(tokens), lines(lines), memory(memory), structure(structure),
+      skipFunctionBodies(false), current(begin), end(end), diags(maxErrors), ir(nullptr),
+      places(memory), consoleOutput(false), semanticChecks(false), symbols(memory),
+      types(memory), returnType(TokenType::INT), nesting(0), tooDeep(false), pool(nullptr),
+      hadError(false) {}
 
 // 入口，解析程序
 bool Parser::parse() {
     bool result = program();
+    printResult(result);
+    return result;
+}
+
+void Parser::printResult(bool result) const {
+    if (!consoleOutput) return;
     if (result) {
         qDebug() << "语法分析成功！";
+        return;
     }
+    for (const QString& message : diags.formatAll(tokens, lines)) {
+        qWarning() << message;
+    }
+}
+
+void Parser::setMaxErrors(int maxErrors) {
+    diags = DiagnosticBuffer(maxErrors);
+}
+
+const DiagnosticBuffer& Parser::diagnostics() const {
+    return diags;
+}
+
+void Parser::setQuadBuilder(QuadBuilder* builder) {
+    ir = builder;
+}
+
+void Parser::setConsoleOutput(bool enabled) {
+    consoleOutput = enabled;
+}
+
+void Parser::setSkipFunctionBodies(bool skip) {
+    skipFunctionBodies = skip;
+}
+
+void Parser::setSemanticChecks(bool enabled) {
+    semanticChecks = enabled;
+}
+
+void Parser::setThreadPool(QThreadPool* pool) {
+    this->pool = pool;
+}
+
+void Parser::setCancelCheck(std::function<bool()> check) {
+    cancelCheck = std::move(check);
+}
+
+bool Parser::nestingExceeded() const {
+    return tooDeep;
+}
+
+namespace {
+
+// 并行分析中由一个工作线程负责的一段连续顶层声明
+struct ParseChunk {
+    int begin;
+    int end;
+    DiagnosticBuffer diagnostics;
+    QuadBuilder quads;
+    bool ok;
+    bool tooDeep;
+};
+
+// 工作线程局部内存池的栈上初始容量，语义栈深度通常很小，超出时向堆申请
+constexpr std::size_t WORKER_ARENA_BYTES = 4096;
+
+// 顶层声明的名字，供并行语义检查时预先登记在各块之前声明的全局名字
+struct GlobalDecl {
+    int begin;      // 声明的第一个 Token 下标
+    int name;       // 标识符 Token 的下标
+    TokenType type;
+    bool isFunction;
+};
+
+bool isTypeKeyword(TokenType type) {
+    return type == TokenType::INT || type == TokenType::FLOAT || type == TokenType::CHAR;
+}
+
+// 块语句的作用域，任何返回路径上都会退出
+class ScopeGuard {
+public:
+    explicit ScopeGuard(SymbolTable* symbols) : symbols(symbols) {
+        if (symbols) symbols->enterScope();
+    }
+    ~ScopeGuard() {
+        if (symbols) symbols->exitScope();
+    }
+
+private:
+    SymbolTable* symbols;
+};
+
+// 递归规则的嵌套深度计数，任何返回路径上都会减回
+class NestingGuard {
+public:
+    explicit NestingGuard(int& nesting) : nesting(nesting) { ++nesting; }
+    ~NestingGuard() { --nesting; }
+
+private:
+    int& nesting;
+};
+
+} // namespace
+
+bool Parser::parseParallel(int minChunkTokens) {
+    const std::pmr::vector<DeclarationRange>& decls = structure->declarations();
+    if (!structure->isBalanced() || decls.size() < 2) {
+        return parse();
+    }
+
+    // 把相邻声明合并成块，块数约为线程数的 4 倍，兼顾负载均衡与调度开销
+    QThreadPool* workers = pool ? pool : QThreadPool::globalInstance();
+    const int threads = std::max(1, workers->maxThreadCount());
+    const int totalTokens = decls.back().end - decls.front().begin;
+    const int grain = std::max(minChunkTokens, totalTokens / (threads * 4));
+
+    std::pmr::vector<ParseChunk> chunks(memory);
+    ParseChunk chunk{decls.front().begin, decls.front().begin, DiagnosticBuffer(diags.maxErrors()), {}, true, false};
+    for (const DeclarationRange& decl : decls) {
+        chunk.end = decl.end;
+        if (chunk.end - chunk.begin >= grain) {
+            chunks.push_back(chunk);
+            chunk.begin = chunk.end;
+        }
+    }
+    if (chunk.end > chunk.begin) chunks.push_back(chunk);
+
+    // 语义检查需要知道每块之前声明的全局名字：顶层声明的轮廓无需完整分析即可取得
+    std::pmr::vector<GlobalDecl> globals(memory);
+    if (semanticChecks) {
+        for (const DeclarationRange& decl : decls) {
+            if (decl.end - decl.begin < 2 || !isTypeKeyword(tokens[decl.begin].type)
+                || tokens[decl.begin + 1].type != TokenType::IDENTIFIER) {
+                continue;
+            }
+            // 与 declaration() 一致：变量在声明符之后即登记，函数只在参数表为空时登记
+            const bool isFunction = decl.begin + 2 < decl.end
+                                    && tokens[decl.begin + 2].type == TokenType::LEFT_PAREN;
+            if (isFunction && (decl.begin + 3 >= decl.end
+                               || tokens[decl.begin + 3].type != TokenType::RIGHT_PAREN)) {
+                continue;
+            }
+            globals.push_back({decl.begin, decl.begin + 1, tokens[decl.begin].type, isFunction});
+        }
+    }
+
+    QtConcurrent::blockingMap(workers, chunks, [this, &globals](ParseChunk& chunk) {
+        // 会话内存池不是线程安全的，工作线程的语义栈使用栈上的局部内存池
+        std::byte buffer[WORKER_ARENA_BYTES];
+        std::pmr::monotonic_buffer_resource local(buffer, sizeof(buffer));
+        Parser worker(tokens, lines, structure, chunk.begin, chunk.end, diags.maxErrors(), &local);
+        worker.skipFunctionBodies = skipFunctionBodies;
+        worker.semanticChecks = semanticChecks;
+        worker.cancelCheck = cancelCheck;
+        for (const GlobalDecl& global : globals) {
+            if (global.begin >= chunk.begin) break;
+            // 重复的全局声明已由所在的块报告，这里只保留第一个
+            worker.symbols.declare(tokens[global.name].value, global.type, global.isFunction,
+                                   global.name);
+        }
+        if (ir) worker.ir = &chunk.quads;
+        chunk.ok = worker.program();
+        chunk.diagnostics = worker.diags;
+        chunk.tooDeep = worker.tooDeep;
+    });
+
+    // 按源码顺序合并各块的结果，总数仍受错误上限约束
+    bool result = true;
+    for (const ParseChunk& chunk : chunks) {
+        diags.append(chunk.diagnostics);
+        if (ir) ir->append(chunk.quads);
+        result = result && chunk.ok;
+        tooDeep = tooDeep || chunk.tooDeep;
+    }
+    hadError = !result;
+    current = end;
+
+    printResult(result);
     return result;
 }
 
 bool Parser::program() {
     while (!isAtEnd()) {
+        // 只在声明之间检查取消，不打断单个声明的分析
+        if (cancelCheck && cancelCheck()) {
+            hadError = true;
+            break;
+        }
         if (!declaration()) {
             synchronize();
         }
@@ -27,31 +226,46 @@ bool Parser::program() {
 // 声明 -> 变量声明 | 函数声明 | 语句
 bool Parser::declaration() {
     if (match(TokenType::INT) || match(TokenType::FLOAT) || match(TokenType::CHAR)) {
+        const TokenType declType = previous().type;
         if (!match(TokenType::IDENTIFIER)) {
-            error(previous(), "变量或函数声明缺少标识符");
+            error(previous(), DiagCode::MISSING_DECL_IDENTIFIER, {TokenType::IDENTIFIER});
             return false;
         }
+        const Token& name = previous();
         if (match(TokenType::LEFT_PAREN)) {
             // 解析函数参数列表（简单示例，支持空参数）
             if (!match(TokenType::RIGHT_PAREN)) {
-                error(peek(), "函数参数列表解析未实现");
+                error(peek(), DiagCode::PARAMETERS_UNSUPPORTED, {TokenType::RIGHT_PAREN});
                 return false;
             }
-            if (!statement()) {
-                error(peek(), "函数体解析失败");
+            declareSymbol(name, declType, true);
+            if (ir) ir->emitQuad(QuadOp::FUNC, Operand::name(name.value));
+            // 只需要声明轮廓时，整个函数体一次跳过
+            if (skipFunctionBodies && check(TokenType::LEFT_BRACE) && skipGroup()) {
+                return true;
+            }
+            const TokenType enclosingReturnType = returnType;
+            returnType = declType;
+            const bool bodyOk = statement();
+            returnType = enclosingReturnType;
+            if (!bodyOk) {
+                error(peek(), DiagCode::INVALID_FUNCTION_BODY);
                 return false;
             }
             return true;
         } else {
-            // 变量声明支持初始化
+            // 变量声明支持初始化；与 C 一样，名字的作用域从声明符之后开始
+            declareSymbol(name, declType, false);
             if (match(TokenType::ASSIGNMENT)) {
                 if (!expression()) {
-                    error(peek(), "变量初始化表达式无效");
+                    error(peek(), DiagCode::INVALID_INITIALIZER);
                     return false;
                 }
+                checkConversion(declType, popType(), name);
+                if (ir) ir->emitQuad(QuadOp::ASSIGN, popPlace(), Operand(), Operand::name(name.value));
             }
             if (!match(TokenType::SEMICOLON)) {
-                error(previous(), "变量声明缺少分号");
+                error(previous(), DiagCode::MISSING_DECL_SEMICOLON, {TokenType::SEMICOLON});
                 return false;
             }
             return true;
@@ -64,13 +278,17 @@ bool Parser::declaration() {
 
 // statement -> expressionStatement | block
 bool Parser::statement() {
+    NestingGuard guard(nesting);
+    if (nesting > MAX_NESTING) return nestingTooDeep();
+
     // 块语句
     if (match(TokenType::LEFT_BRACE)) {
+        ScopeGuard scope(semanticChecks ? &symbols : nullptr);
         while (!check(TokenType::RIGHT_BRACE) && !isAtEnd()) {
             if (!declaration()) return false;
         }
         if (!match(TokenType::RIGHT_BRACE)) {
-            error(peek(), "缺少右花括号");
+            error(peek(), DiagCode::MISSING_RIGHT_BRACE, {TokenType::RIGHT_BRACE});
             return false;
         }
         return true;
@@ -79,32 +297,48 @@ bool Parser::statement() {
     // if语句
     if (match(TokenType::IF)) {
         if (!match(TokenType::LEFT_PAREN)) {
-            error(peek(), "if语句缺少左括号");
+            error(peek(), DiagCode::IF_MISSING_LEFT_PAREN, {TokenType::LEFT_PAREN});
             return false;
         }
         if (!expression()) return false;  // 条件表达式
+        popType();
         if (!match(TokenType::RIGHT_PAREN)) {
-            error(peek(), "if语句缺少右括号");
+            error(peek(), DiagCode::IF_MISSING_RIGHT_PAREN, {TokenType::RIGHT_PAREN});
             return false;
         }
+        // 条件为假时跳过if语句体，目标待回填
+        int falseJump = ir ? ir->emitQuad(QuadOp::JZ, popPlace()) : -1;
         if (!statement()) return false;   // if语句体
         // 可选else分支
         if (match(TokenType::ELSE)) {
+            int endJump = -1;
+            if (ir) {
+                endJump = ir->emitQuad(QuadOp::JMP);
+                ir->patch(falseJump, ir->nextIndex());
+            }
             if (!statement()) return false;
+            if (ir) ir->patch(endJump, ir->nextIndex());
+        } else if (ir) {
+            ir->patch(falseJump, ir->nextIndex());
         }
         return true;
     }
 
     // return语句
     if (match(TokenType::RETURN)) {
+        const Token& keyword = previous();
         // return后可跟表达式，也可以直接分号
+        Operand value;
         if (!check(TokenType::SEMICOLON)) {
             if (!expression()) return false;
+            value = popPlace();
+            checkConversion(returnType, popType(), keyword);
         }
         if (!match(TokenType::SEMICOLON)) {
-            error(previous(), "return语句缺少分号");
+            error(previous(), DiagCode::RETURN_MISSING_SEMICOLON, {TokenType::SEMICOLON});
             return false;
         }
+        if (ir) ir->emitQuad(QuadOp::RETURN, value);
         return true;
     }
 
@@ -117,8 +351,10 @@ bool Parser::statement() {
 // expressionStatement -> expression ';'
 bool Parser::expressionStatement() {
     if (!expression()) return false;
+    popPlace(); // 表达式的值不再使用
+    popType();
     if (!match(TokenType::SEMICOLON)) {
-        error(previous(), "缺少语句结束的分号");
+        error(previous(), DiagCode::MISSING_STATEMENT_SEMICOLON, {TokenType::SEMICOLON});
         return false;
     }
     return true;
@@ -131,12 +367,23 @@ bool Parser::expression() {
 
 // assignment -> IDENTIFIER '=' assignment | equality
 bool Parser::assignment() {
+    NestingGuard guard(nesting);
+    if (nesting > MAX_NESTING) return nestingTooDeep();
+
     if (match(TokenType::IDENTIFIER)) {
+        const Token& target = previous();
         if (match(TokenType::ASSIGNMENT)) {
+            const TokenType targetType = useSymbol(target);
             if (!assignment()) {
-                error(peek(), "赋值表达式右侧无效");
+                error(peek(), DiagCode::INVALID_ASSIGNMENT_VALUE);
                 return false;
             }
+            checkConversion(targetType, popType(), target);
+            pushType(targetType);
+            if (ir) {
+                ir->emitQuad(QuadOp::ASSIGN, popPlace(), Operand(), Operand::name(target.value));
+                pushPlace(Operand::name(target.value));
+            }
             return true;
         } else {
             // 回退，当前Token不是赋值符号，回到IDENTIFIER
@@ -150,7 +397,10 @@ bool Parser::assignment() {
 bool Parser::equality() {
     if (!comparison()) return false;
     while (match(TokenType::EQUAL) || match(TokenType::NOT_EQUAL)) {
+        TokenType op = previous().type;
         if (!comparison()) return false;
+        emitBinary(op);
+        combineTypes(op);
     }
     return true;
 }
@@ -160,7 +410,10 @@ bool Parser::comparison() {
     if (!term()) return false;
     while (match(TokenType::LESS) || match(TokenType::LESS_EQUAL) ||
            match(TokenType::GREATER) || match(TokenType::GREATER_EQUAL)) {
+        TokenType op = previous().type;
         if (!term()) return false;
+        emitBinary(op);
+        combineTypes(op);
     }
     return true;
 }
@@ -169,7 +422,10 @@ bool Parser::comparison() {
 bool Parser::term() {
     if (!factor()) return false;
     while (match(TokenType::PLUS) || match(TokenType::MINUS)) {
+        TokenType op = previous().type;
         if (!factor()) return false;
+        emitBinary(op);
+        combineTypes(op);
     }
     return true;
 }
@@ -178,36 +434,147 @@ bool Parser::term() {
 bool Parser::factor() {
     if (!unary()) return false;
     while (match(TokenType::MULTIPLY) || match(TokenType::DIVIDE)) {
+        TokenType op = previous().type;
         if (!unary()) return false;
+        emitBinary(op);
+        combineTypes(op);
     }
     return true;
 }
 
 // unary -> ( '!' | '-' ) unary | primary
 bool Parser::unary() {
+    NestingGuard guard(nesting);
+    if (nesting > MAX_NESTING) return nestingTooDeep();
+
     if (match(TokenType::BANG) || match(TokenType::MINUS)) {
-        return unary();
+        TokenType op = previous().type;
+        if (!unary()) return false;
+        if (ir) {
+            Operand operand = popPlace();
+            Operand temp = ir->newTemp();
+            ir->emitQuad(op == TokenType::BANG ? QuadOp::NOT : QuadOp::NEG, operand, Operand(), temp);
+            pushPlace(temp);
+        }
+        if (op == TokenType::BANG) {
+            popType();
+            pushType(TokenType::INT);
+        }
+        return true;
     }
     return primary();
 }
 
 // primary -> NUMBER | IDENTIFIER | '(' expression ')'
 bool Parser::primary() {
-    if (match(TokenType::NUMBER) || match(TokenType::IDENTIFIER)) {
+    if (match(TokenType::NUMBER)) {
+        pushPlace(Operand::constant(previous().value));
+        pushType(previous().value.contains('.') ? TokenType::FLOAT : TokenType::INT);
+        return true;
+    }
+    if (match(TokenType::IDENTIFIER)) {
+        pushPlace(Operand::name(previous().value));
+        pushType(useSymbol(previous()));
         return true;
     }
     if (match(TokenType::LEFT_PAREN)) {
         if (!expression()) return false;
         if (!match(TokenType::RIGHT_PAREN)) {
-            error(peek(), "缺少右括号");
+            error(peek(), DiagCode::MISSING_RIGHT_PAREN, {TokenType::RIGHT_PAREN});
             return false;
         }
         return true;
     }
-    error(peek(), "预期数字、标识符或括号表达式");
+    error(peek(), DiagCode::EXPECTED_PRIMARY,
+          {TokenType::NUMBER, TokenType::IDENTIFIER, TokenType::LEFT_PAREN});
     return false;
 }
 
+// 语义栈与四元式生成
+
+void Parser::pushPlace(const Operand& place) {
+    if (ir) places.push_back(place);
+}
+
+Operand Parser::popPlace() {
+    if (places.empty()) return Operand();
+    Operand place = std::move(places.back());
+    places.pop_back();
+    return place;
+}
+
+void Parser::emitBinary(TokenType op) {
+    if (!ir) return;
+    Operand right = popPlace();
+    Operand left = popPlace();
+    Operand temp = ir->newTemp();
+    ir->emitQuad(binaryQuadOp(op), left, right, temp);
+    pushPlace(temp);
+}
+
+// 语义检查
+
+void Parser::pushType(TokenType type) {
+    if (semanticChecks) types.push_back(type);
+}
+
+TokenType Parser::popType() {
+    if (types.empty()) return TokenType::INT;
+    const TokenType type = types.back();
+    types.pop_back();
+    return type;
+}
+
+void Parser::combineTypes(TokenType op) {
+    if (!semanticChecks) return;
+    const TokenType right = popType();
+    const TokenType left = popType();
+    switch (op) {
+        case TokenType::PLUS:
+        case TokenType::MINUS:
+        case TokenType::MULTIPLY:
+        case TokenType::DIVIDE:
+            // 算术运算取较宽的类型：char < int < float
+            if (left == TokenType::FLOAT || right == TokenType::FLOAT) {
+                pushType(TokenType::FLOAT);
+            } else {
+                pushType(TokenType::INT);
+            }
+            break;
+        default:
+            pushType(TokenType::INT); // 比较运算的结果为 int
+            break;
+    }
+}
+
+void Parser::declareSymbol(const Token& name, TokenType type, bool isFunction) {
+    if (!semanticChecks) return;
+    const int index = static_cast<int>(&name - tokens.constData());
+    if (!symbols.declare(name.value, type, isFunction, index)) {
+        error(name, DiagCode::REDECLARED_IDENTIFIER);
+    }
+}
+
+TokenType Parser::useSymbol(const Token& name) {
+    if (!semanticChecks) return TokenType::INT;
+    const Symbol* symbol = symbols.lookup(name.value);
+    if (!symbol) {
+        error(name, DiagCode::UNDECLARED_IDENTIFIER);
+        return TokenType::INT;
+    }
+    if (symbol->isFunction) {
+        error(name, DiagCode::FUNCTION_AS_VALUE);
+    }
+    return symbol->type;
+}
+
+void Parser::checkConversion(TokenType target, TokenType value, const Token& at) {
+    if (!semanticChecks) return;
+    if (value == TokenType::FLOAT && target != TokenType::FLOAT) {
+        error(at, DiagCode::TYPE_MISMATCH);
+    }
+}
+
 // 工具函数实现
 
 bool Parser::match(TokenType type) {
@@ -229,7 +596,7 @@ const Token& Parser::advance() {
 }
 
 bool Parser::isAtEnd() const {
-    return peek().type == TokenType::EOF_TOKEN;
+    return current >= end;
 }
 
 const Token& Parser::peek() const {
@@ -240,33 +607,34 @@ const Token& Parser::previous() const {
     return tokens[current - 1];
 }
 
-void Parser::error(const Token& token, const QString& message) {
+bool Parser::skipGroup() {
+    if (!check(TokenType::LEFT_PAREN) && !check(TokenType::LEFT_BRACE)) return false;
+    int close = structure->matching(current);
+    if (close < 0) return false;
+    current = close + 1;
+    return true;
+}
+
+void Parser::error(const Token& token, DiagCode code, TokenTypeSet expected) {
     hadError = true;
-    QString errorMsg = QString("语法错误 [行 %1]: %2 (Token: %3)")
-                       .arg(token.line)
-                       .arg(message)
-                       .arg(token.value.isEmpty() ? getTokenTypeString(token.type) : token.value);
-    qWarning() << errorMsg;
+    const int index = static_cast<int>(&token - tokens.constData());
+    // 只记录结构化信息，文本在分析结束后再生成；超出上限时立即终止分析
+    if (!diags.report(code, index, expected)) {
+        current = end;
+    }
+}
+
+bool Parser::nestingTooDeep() {
+    if (!tooDeep) error(peek(), DiagCode::NESTING_TOO_DEEP);
+    tooDeep = true;
+    current = end;
+    return false;
 }
 
 void Parser::synchronize() {
+    places.clear();
+    types.clear();
     advance();
-
-    while (!isAtEnd()) {
-        if (previous().type == TokenType::SEMICOLON) return;
-
-        switch (peek().type) {
-            case TokenType::INT:
-            case TokenType::FLOAT:
-            case TokenType::CHAR:
-            case TokenType::IF:
-            case TokenType::WHILE:
-            case TokenType::FOR:
-            case TokenType::RETURN:
-                return;
-            default:
-                break;
-        }
-        advance();
-    }
+    // 同步点已在结构索引中预先算好，一步跳到位
+    current = std::min(structure->nextSyncPoint(current), end);
 }
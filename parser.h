@@ -3,21 +3,37 @@
 
 #include <QVector>
 #include <QString>
+#include <functional>
+#include <memory_resource>
 #include "token.h"
+#include "lineindex.h"
+#include "structuralindex.h"
+#include "diagnostics.h"
+#include "quad.h"
+#include "symboltable.h"
+
+class QThreadPool;
 
 /**
  * @class Parser
  * @brief 递归下降语法分析器，用于对词法分析器生成的Token序列进行语法检查和结构分析。
  *
  * 支持简单C语言子集的语法规则，包括变量声明、表达式语句、块语句等。
+ *
+ * 每层嵌套的块、if 语句、括号和一元运算都会占用若干层 C++ 调用栈，嵌套深度超过
+ * MAX_NESTING 时停止分析并报告 NESTING_TOO_DEEP，调用方可改用不递归的 LalrParser。
  */
 class Parser {
 public:
     /**
      * @brief 构造函数，初始化语法分析器。
      * @param tokens 词法分析器生成的Token序列。
+     * @param lines 源代码的行首索引，用于在错误信息中给出行列号；为空时只报告偏移量。
+     * @param memory 结构索引与语义栈使用的内存资源，通常为编译会话的内存池（见 CompileArena）。
+     *               该资源只在构造分析器的线程上使用，并行分析的工作线程各用局部内存池。
      */
-    Parser(const QVector<Token>& tokens);
+    Parser(const QVector<Token>& tokens, const LineIndex* lines = nullptr,
+           std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
     /**
      * @brief 执行语法分析，入口函数。
@@ -25,9 +41,118 @@ public:
      */
     bool parse();
 
+    /**
+     * @brief 设置是否跳过函数体，只分析声明轮廓。
+     *
+     * 开启后函数体借助结构索引 O(1) 跳过，不再逐 Token 分析。
+     * @param skip 是否跳过函数体。
+     */
+    void setSkipFunctionBodies(bool skip);
+
+    /**
+     * @brief 并行语法分析。
+     *
+     * 先按结构索引在顶层声明边界处把 Token 序列切分成若干块，再在线程池（见
+     * setThreadPool()）上并行分析各块；每个工作线程有独立的错误信息缓冲区，全部完成后按源码顺序合并输出。
+     * 括号不配对或声明过少时退化为顺序分析。
+     * @param minChunkTokens 每块至少包含的 Token 数，避免任务过碎。
+     * @return 语法分析成功返回true，否则返回false。
+     */
+    bool parseParallel(int minChunkTokens = 4096);
+
+    /**
+     * @brief 设置最多记录的错误条数，达到上限后立即停止分析。
+     * @param maxErrors 错误上限。
+     */
+    void setMaxErrors(int maxErrors);
+
+    /**
+     * @brief 返回分析过程中记录的结构化错误信息。
+     */
+    const DiagnosticBuffer& diagnostics() const;
+
+    /**
+     * @brief 设置四元式生成缓冲区，分析的同时进行语法制导翻译。
+     *
+     * 为空时只做语法检查。只有分析成功时生成的四元式才有意义。
+     * @param builder 四元式缓冲区，由调用方持有。
+     */
+    void setQuadBuilder(QuadBuilder* builder);
+
+    /**
+     * @brief 设置分析结束后是否把结果与错误信息输出到控制台，默认输出。
+     * @param enabled 是否输出。
+     */
+    void setConsoleOutput(bool enabled);
+
+    /**
+     * @brief 设置是否在分析的同时进行语义检查，默认关闭。
+     *
+     * 开启后用作用域符号表检查未声明的标识符、同一作用域内的重复声明、把函数名当作值
+     * 使用，以及 float 值隐式赋给 int/char 变量（初始化、赋值与 return）。
+     * @param enabled 是否检查。
+     */
+    void setSemanticChecks(bool enabled);
+
+    /**
+     * @brief 设置并行分析使用的线程池，为空时使用全局线程池。
+     *
+     * 调用线程本身也参与分析，线程池没有空闲线程时各块在调用线程上依次完成。
+     * @param pool 线程池，由调用方持有。
+     */
+    void setThreadPool(QThreadPool* pool);
+
+    /**
+     * @brief 设置取消检查，分析过程中在每个顶层声明之前调用。
+     *
+     * 返回 true 时立即停止分析并返回失败，已记录的错误与四元式不完整。并行分析的
+     * 工作线程也会调用它，因此它必须是线程安全的。为空时不检查。
+     * @param check 取消检查。
+     */
+    void setCancelCheck(std::function<bool()> check);
+
+    /**
+     * @brief 判断分析是否因嵌套过深而提前停止。
+     */
+    bool nestingExceeded() const;
+
+    static constexpr int MAX_NESTING = 256; ///< 递归分析允许的最大嵌套深度。
+
 private:
-    const QVector<Token>& tokens; ///< 词法分析得到的Token列表
-    int current;                  ///< 当前解析到的Token索引
+    /**
+     * @brief 构造只分析 Token 子区间的分析器，供并行分析的工作线程使用。
+     * @param tokens 完整的Token序列。
+     * @param lines 源代码的行首索引，可为空。
+     * @param structure 完整序列的结构索引。
+     * @param begin 子区间起始下标。
+     * @param end 子区间结束下标（不含）。
+     * @param maxErrors 错误上限。
+     * @param memory 语义栈使用的内存资源。
+     */
+    Parser(const QVector<Token>& tokens, const LineIndex* lines,
+           const StructuralIndex* structure, int begin, int end, int maxErrors,
+           std::pmr::memory_resource* memory);
+
+    const QVector<Token>& tokens;      ///< 词法分析得到的Token列表
+    const LineIndex* lines;            ///< 源代码行首索引，可为空
+    std::pmr::memory_resource* memory; ///< 按会话分配的内存资源
+    StructuralIndex ownStructure;      ///< 自行构建的结构索引，子区间分析器不使用
+    const StructuralIndex* structure;  ///< 括号配对与顶层声明索引
+    bool skipFunctionBodies;           ///< 是否跳过函数体
+    int current;                       ///< 当前解析到的Token索引
+    int end;                           ///< 分析范围的结束下标（不含），默认为 EOF_TOKEN 的下标
+    DiagnosticBuffer diags;            ///< 结构化错误信息缓冲区
+    QuadBuilder* ir;                   ///< 四元式缓冲区，为空时不生成中间代码
+    std::pmr::vector<Operand> places;  ///< 语义栈，保存各子表达式结果所在的位置
+    bool consoleOutput;                ///< 是否向控制台输出分析结果
+    bool semanticChecks;               ///< 是否进行语义检查
+    SymbolTable symbols;               ///< 作用域符号表
+    std::pmr::vector<TokenType> types; ///< 类型栈，保存各子表达式的类型（INT/FLOAT/CHAR）
+    TokenType returnType;              ///< 当前函数的返回类型
+    int nesting;                       ///< 当前的递归嵌套深度
+    bool tooDeep;                      ///< 是否因嵌套过深而停止
+    std::function<bool()> cancelCheck; ///< 取消检查，为空时不检查
+    QThreadPool* pool;                 ///< 并行分析使用的线程池，为空时使用全局线程池
 
     /**
      * @brief 顶层程序规则，解析整个程序。
@@ -140,18 +265,95 @@ private:
     const Token& previous() const;
 
     /**
-     * @brief 语法错误报告函数，打印错误信息并标记错误状态。
+     * @brief 把子表达式的结果位置压入语义栈（未设置四元式缓冲区时忽略）。
+     */
+    void pushPlace(const Operand& place);
+
+    /**
+     * @brief 弹出语义栈顶的结果位置，栈为空时返回空操作数。
+     */
+    Operand popPlace();
+
+    /**
+     * @brief 弹出两个操作数，生成一条二元运算四元式，并把结果临时变量压栈。
+     * @param op 运算符对应的Token类型。
+     */
+    void emitBinary(TokenType op);
+
+    /**
+     * @brief 把子表达式的类型压入类型栈（未开启语义检查时忽略）。
+     */
+    void pushType(TokenType type);
+
+    /**
+     * @brief 弹出类型栈顶的类型，栈为空时返回 INT。
+     */
+    TokenType popType();
+
+    /**
+     * @brief 弹出二元运算的两个操作数类型，压入结果类型。
+     * @param op 运算符对应的Token类型。
+     */
+    void combineTypes(TokenType op);
+
+    /**
+     * @brief 在当前作用域中声明名字，重复声明时报告错误。
+     * @param name 声明处的标识符Token。
+     * @param type 声明的类型。
+     * @param isFunction 是否为函数。
+     */
+    void declareSymbol(const Token& name, TokenType type, bool isFunction);
+
+    /**
+     * @brief 查找被引用的名字，未声明或为函数时报告错误。
+     * @param name 被引用的标识符Token。
+     * @return 名字的类型；未声明时返回 INT，以免引出更多错误。
+     */
+    TokenType useSymbol(const Token& name);
+
+    /**
+     * @brief 检查把 value 类型的值隐式转换为 target 类型是否允许。
+     * @param target 目标类型。
+     * @param value 值的类型。
+     * @param at 报告错误的位置。
+     */
+    void checkConversion(TokenType target, TokenType value, const Token& at);
+
+    /**
+     * @brief 报告嵌套过深并把当前位置移到分析范围末尾，使分析立即结束。
+     * @return 总是返回 false。
+     */
+    bool nestingTooDeep();
+
+    /**
+     * @brief 若当前Token为已配对的 '(' 或 '{'，直接跳到与之配对的括号之后。
+     * @return 是否发生了跳转。
+     */
+    bool skipGroup();
+
+    /**
+     * @brief 语法错误报告函数，记录错误并标记错误状态。
+     *
+     * 错误数量超过上限时把当前位置移到分析范围末尾，使分析尽快结束。
      * @param token 出错的Token。
-     * @param message 错误描述信息。
+     * @param code 错误种类。
+     * @param expected 期望的Token类型。
      */
-    void error(const Token& token, const QString& message);
+    void error(const Token& token, DiagCode code, TokenTypeSet expected = TokenTypeSet());
 
     /**
      * @brief 同步错误恢复函数。
      * 遇到语法错误时，跳过无效Token直到找到可能的语句起始Token，避免错误传播。
+     * 途中遇到的完整括号组整体跳过，借助结构索引一步到位。
      */
     void synchronize();
 
+    /**
+     * @brief 输出分析结果：成功信息，或格式化后的全部错误信息。
+     * @param result 语法分析是否成功。
+     */
+    void printResult(bool result) const;
+
     bool hadError; ///< 标记是否出现语法错误
 };
 
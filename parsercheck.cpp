@@ -0,0 +1,425 @@
+#include "parsercheck.h"
+#include "arena.h"
+#include "lalrparser.h"
+#include "parser.h"
+#include "preprocessor.h"
+#include "quad.h"
+#include "scanner.h"
+#include "sourcetext.h"
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+
+namespace {
+
+// 未给出源文件时检查的随机程序个数与默认随机种子
+constexpr int DEFAULT_RANDOM = 2000;
+constexpr quint32 DEFAULT_SEED = 1;
+
+// 随机程序使用的名字与运算符；名字很少，以便产生重复声明与未声明的引用
+const char *const NAMES[] = {"a", "b", "c", "f", "g"};
+const char *const TYPES[] = {"int", "float", "char"};
+const char *const BINARY_OPERATORS[] = {"+", "-", "*", "/", "<", "<=", ">", ">=", "==", "!="};
+
+template <typename T, int N>
+constexpr int countOf(T (&)[N]) { return N; }
+
+QVector<Token> scan(const QString &source)
+{
+    Scanner scanner(source);
+    scanner.setWarningsEnabled(false);
+    return scanner.scanTokens();
+}
+
+// 第一条语法错误的下标，没有时返回 -1
+int firstSyntaxError(const DiagnosticBuffer &diags)
+{
+    for (int i = 0; i < diags.size(); ++i) {
+        if (!isSemanticError(diags.at(i).code)) return i;
+    }
+    return -1;
+}
+
+QString formatOrNone(const DiagnosticBuffer &diags, int i, const QVector<Token> &tokens,
+                     const LineIndex *lines)
+{
+    return i < diags.size() ? diags.format(i, tokens, lines) : QString("（无）");
+}
+
+QString formatOrNone(const QuadBuilder &quads, int i)
+{
+    return i < quads.quads().size() ? quads.format(i) : QString("（无）");
+}
+
+// 一个分析器的输出，供逐项比较
+struct ParseResult {
+    const char *name;
+    const DiagnosticBuffer &diags;
+    const QuadBuilder &quads;
+};
+
+// 比较两个分析器的输出：是否存在语法错误须一致；都没有语法错误时，语义错误与四元式逐条相同
+QString difference(const ParseResult &left, const ParseResult &right, const QVector<Token> &tokens,
+                   const LineIndex *lines)
+{
+    const int leftSyntax = firstSyntaxError(left.diags);
+    const int rightSyntax = firstSyntaxError(right.diags);
+    if ((leftSyntax < 0) != (rightSyntax < 0)) {
+        return leftSyntax >= 0
+                   ? QString("只有 %1 报告语法错误：").arg(left.name) + left.diags.format(leftSyntax, tokens, lines)
+                   : QString("只有 %1 报告语法错误：").arg(right.name) + right.diags.format(rightSyntax, tokens, lines);
+    }
+    // 两者都有语法错误时，错误种类与恢复方式本来就不同，不再比较
+    if (leftSyntax >= 0) return QString();
+
+    for (int i = 0; i < qMax(left.diags.size(), right.diags.size()); ++i) {
+        if (i < left.diags.size() && i < right.diags.size() && left.diags.at(i).code == right.diags.at(i).code
+            && left.diags.at(i).tokenIndex == right.diags.at(i).tokenIndex) {
+            continue;
+        }
+        return QString("第 %1 条语义错误不同：%2 %3；%4 %5")
+            .arg(i + 1)
+            .arg(left.name, formatOrNone(left.diags, i, tokens, lines))
+            .arg(right.name, formatOrNone(right.diags, i, tokens, lines));
+    }
+
+    for (int i = 0; i < qMax(left.quads.quads().size(), right.quads.quads().size()); ++i) {
+        const QString leftQuad = formatOrNone(left.quads, i);
+        const QString rightQuad = formatOrNone(right.quads, i);
+        if (leftQuad != rightQuad) {
+            return QString("第 %1 条四元式不同：%2 %3；%4 %5")
+                .arg(i + 1)
+                .arg(left.name, leftQuad)
+                .arg(right.name, rightQuad);
+        }
+    }
+    return QString();
+}
+
+} // namespace
+
+ParserCheck::ParserCheck(const QStringList &arguments)
+    : randomCount(-1)
+    , rng(DEFAULT_SEED)
+    , skipped(0)
+    , tokenCount(0)
+    , recursiveNs(0)
+    , lalrNs(0)
+{
+    for (int i = 0; i < arguments.size(); ++i) {
+        const QString &argument = arguments[i];
+        if (argument == "--random" && i + 1 < arguments.size()) {
+            randomCount = arguments[++i].toInt();
+        } else if (argument == "--seed" && i + 1 < arguments.size()) {
+            rng.seed(arguments[++i].toUInt());
+        } else {
+            paths.append(argument);
+        }
+    }
+    if (randomCount < 0) randomCount = paths.isEmpty() ? DEFAULT_RANDOM : 0;
+}
+
+int ParserCheck::run()
+{
+    QTextStream out(stdout);
+    int checked = 0;
+    int failures = 0;
+
+    for (const QString &path : paths) {
+        const QString difference = checkFile(path);
+        ++checked;
+        if (difference.isEmpty()) continue;
+        ++failures;
+        out << path << ": " << difference << "\n";
+    }
+
+    // 随机程序一半保持原样，一半经过变异，两种情况都要求两个分析器一致
+    for (int i = 0; i < randomCount; ++i) {
+        const QString source = randomProgram();
+        const LineIndex lines(source);
+        QVector<Token> tokens = scan(source);
+        const bool mutated = i % 2 == 1;
+        if (mutated) mutate(tokens);
+        const QString difference = compare(tokens, mutated ? nullptr : &lines);
+        ++checked;
+        if (difference.isEmpty()) continue;
+        ++failures;
+        out << QString("随机程序 #%1%2: ").arg(i).arg(mutated ? "（变异后）" : "") << difference << "\n"
+            << source << "\n";
+    }
+
+    const QString deep = checkDeepNesting();
+    if (!deep.isEmpty()) {
+        ++failures;
+        out << deep << "\n";
+    }
+
+    const QString broken = checkBrokenDeclarations();
+    if (!broken.isEmpty()) {
+        ++failures;
+        out << broken << "\n";
+    }
+
+    out << QString("检查了 %1 个程序，%2 处不一致").arg(checked).arg(failures);
+    if (skipped > 0) out << QString("，%1 个因嵌套过深未比较").arg(skipped);
+    out << "\n";
+    if (recursiveNs > 0 && lalrNs > 0) {
+        out << QString("吞吐量：Parser %1 万 Token/秒，LalrParser %2 万 Token/秒\n")
+                   .arg(tokenCount * 1e5 / recursiveNs, 0, 'f', 1)
+                   .arg(tokenCount * 1e5 / lalrNs, 0, 'f', 1);
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+QString ParserCheck::compare(const QVector<Token> &tokens, const LineIndex *lines)
+{
+    CompileArena arena;
+    QElapsedTimer timer;
+
+    timer.start();
+    QuadBuilder recursiveQuads;
+    Parser recursive(tokens, lines, arena.resource());
+    recursive.setConsoleOutput(false);
+    recursive.setQuadBuilder(&recursiveQuads);
+    recursive.setSemanticChecks(true);
+    recursive.parse();
+    recursiveNs += timer.nsecsElapsed();
+
+    timer.restart();
+    QuadBuilder lalrQuads;
+    LalrParser lalr(tokens, lines, arena.resource());
+    lalr.setConsoleOutput(false);
+    lalr.setQuadBuilder(&lalrQuads);
+    lalr.setSemanticChecks(true);
+    lalr.parse();
+    lalrNs += timer.nsecsElapsed();
+    tokenCount += tokens.size();
+
+    if (recursive.nestingExceeded()) {
+        ++skipped;
+        return QString();
+    }
+
+    const ParseResult sequential{"Parser", recursive.diagnostics(), recursiveQuads};
+    const QString lalrDifference =
+        difference(sequential, {"LalrParser", lalr.diagnostics(), lalrQuads}, tokens, lines);
+    if (!lalrDifference.isEmpty()) return lalrDifference;
+
+    // 每个顶层声明单独成块的并行分析应与顺序分析完全一致，块边界因此落在每个可能的切分点上
+    QuadBuilder parallelQuads;
+    Parser parallel(tokens, lines, arena.resource());
+    parallel.setConsoleOutput(false);
+    parallel.setQuadBuilder(&parallelQuads);
+    parallel.setSemanticChecks(true);
+    parallel.parseParallel(1);
+    return difference(sequential, {"Parser::parseParallel", parallel.diagnostics(), parallelQuads}, tokens,
+                      lines);
+}
+
+QString ParserCheck::checkFile(const QString &path)
+{
+    QString text;
+    if (!readSourceText(path, text)) return "无法读取文件";
+    const LineIndex lines(text);
+    Preprocessor preprocessor(path);
+    preprocessor.setIncludePaths({QFileInfo(path).absolutePath()});
+    const QVector<Token> tokens = preprocessor.process(text, scan(text));
+    return compare(tokens, &lines);
+}
+
+QString ParserCheck::checkDeepNesting()
+{
+    const struct {
+        const char *name;
+        QString source;
+    } cases[] = {
+        {"括号", "int x = " + QString("(").repeated(DEEP_NESTING) + "1" + QString(")").repeated(DEEP_NESTING) + ";"},
+        {"块", QString("{").repeated(DEEP_NESTING) + QString("}").repeated(DEEP_NESTING)},
+        {"一元运算", "int x = " + QString("- ").repeated(DEEP_NESTING) + "1;"},
+        {"if", "int x;\n" + QString("if (x) ").repeated(DEEP_NESTING) + "x = 1;"},
+        {"else if", "int x;\n" + QString("if (x) x = 1; else ").repeated(DEEP_NESTING) + "x = 2;"},
+    };
+
+    for (const auto &deep : cases) {
+        const QVector<Token> tokens = scan(deep.source);
+        CompileArena arena;
+        Parser recursive(tokens, nullptr, arena.resource());
+        recursive.setConsoleOutput(false);
+        recursive.setSemanticChecks(true);
+        recursive.parse();
+        if (!recursive.nestingExceeded()) {
+            return QString("深度嵌套（%1）：Parser 没有报告嵌套过深").arg(deep.name);
+        }
+
+        QuadBuilder quads;
+        LalrParser lalr(tokens, nullptr, arena.resource());
+        lalr.setConsoleOutput(false);
+        lalr.setQuadBuilder(&quads);
+        lalr.setSemanticChecks(true);
+        if (!lalr.parse()) {
+            return QString("深度嵌套（%1）：LalrParser 分析失败：%2")
+                .arg(deep.name, formatOrNone(lalr.diagnostics(), 0, tokens, nullptr));
+        }
+    }
+    return QString();
+}
+
+QString ParserCheck::checkBrokenDeclarations()
+{
+    const struct {
+        const char *name;
+        const char *source;
+    } cases[] = {
+        {"带参数的函数", "int f(int a) { return a; }\nint g() { return f; }\nint h() { return f; }\n"},
+        {"缺少初始值", "int x = ;\nint y = x;\nint z = x;\n"},
+        {"缺少分号", "float v\nint w() { return v; }\n"},
+        {"函数声明", "char p(char c);\nint q() { return p; }\n"},
+    };
+
+    for (const auto &broken : cases) {
+        const QVector<Token> tokens = scan(broken.source);
+        CompileArena arena;
+        Parser sequential(tokens, nullptr, arena.resource());
+        sequential.setConsoleOutput(false);
+        sequential.setSemanticChecks(true);
+        sequential.parse();
+
+        Parser parallel(tokens, nullptr, arena.resource());
+        parallel.setConsoleOutput(false);
+        parallel.setSemanticChecks(true);
+        parallel.parseParallel(1);
+
+        const DiagnosticBuffer &left = sequential.diagnostics();
+        const DiagnosticBuffer &right = parallel.diagnostics();
+        for (int i = 0; i < qMax(left.size(), right.size()); ++i) {
+            if (i < left.size() && i < right.size() && left.at(i).code == right.at(i).code
+                && left.at(i).tokenIndex == right.at(i).tokenIndex) {
+                continue;
+            }
+            return QString("声明头出错（%1）：第 %2 条错误不同：Parser %3；Parser::parseParallel %4")
+                .arg(broken.name)
+                .arg(i + 1)
+                .arg(formatOrNone(left, i, tokens, nullptr), formatOrNone(right, i, tokens, nullptr));
+        }
+    }
+    return QString();
+}
+
+QString ParserCheck::randomProgram()
+{
+    QString out;
+    const int count = 1 + rng.bounded(6);
+    for (int i = 0; i < count; ++i) randomDeclaration(out, 0);
+    return out;
+}
+
+void ParserCheck::randomDeclaration(QString &out, int depth)
+{
+    const QString type = TYPES[rng.bounded(countOf(TYPES))];
+    const QString name = NAMES[rng.bounded(countOf(NAMES))];
+    switch (rng.bounded(5)) {
+        case 0:
+            out += type + " " + name + ";\n";
+            break;
+        case 1:
+            out += type + " " + name + " = ";
+            randomExpression(out, depth);
+            out += ";\n";
+            break;
+        case 2:
+            out += type + " " + name + "() ";
+            randomStatement(out, depth + 1);
+            break;
+        default:
+            randomStatement(out, depth);
+            break;
+    }
+}
+
+void ParserCheck::randomStatement(QString &out, int depth)
+{
+    switch (depth >= MAX_DEPTH ? 5 : rng.bounded(6)) {
+        case 0: {
+            out += "{\n";
+            const int count = rng.bounded(4);
+            for (int i = 0; i < count; ++i) randomDeclaration(out, depth + 1);
+            out += "}\n";
+            break;
+        }
+        case 1:
+        case 2:
+            out += "if (";
+            randomExpression(out, depth + 1);
+            out += ") ";
+            randomStatement(out, depth + 1);
+            if (rng.bounded(2) == 0) {
+                out += "else ";
+                randomStatement(out, depth + 1);
+            }
+            break;
+        case 3:
+            out += "return;\n";
+            break;
+        case 4:
+            out += "return ";
+            randomExpression(out, depth + 1);
+            out += ";\n";
+            break;
+        default:
+            randomExpression(out, depth + 1);
+            out += ";\n";
+            break;
+    }
+}
+
+void ParserCheck::randomExpression(QString &out, int depth)
+{
+    switch (depth >= MAX_DEPTH ? 5 : rng.bounded(7)) {
+        case 0:
+            out += QString(NAMES[rng.bounded(countOf(NAMES))]) + " = ";
+            randomExpression(out, depth + 1);
+            break;
+        case 1:
+        case 2:
+            randomExpression(out, depth + 1);
+            out += QString(" %1 ").arg(BINARY_OPERATORS[rng.bounded(countOf(BINARY_OPERATORS))]);
+            randomExpression(out, depth + 1);
+            break;
+        case 3:
+            out += rng.bounded(2) == 0 ? "!" : "- ";
+            randomExpression(out, depth + 1);
+            break;
+        case 4:
+            out += "(";
+            randomExpression(out, depth + 1);
+            out += ")";
+            break;
+        default:
+            if (rng.bounded(2) == 0) {
+                out += NAMES[rng.bounded(countOf(NAMES))];
+            } else {
+                out += rng.bounded(4) == 0 ? QString("2.5") : QString::number(rng.bounded(100));
+            }
+            break;
+    }
+}
+
+void ParserCheck::mutate(QVector<Token> &tokens)
+{
+    const int count = int(tokens.size()) - 1; // 不含 EOF_TOKEN
+    if (count < 1) return;
+    const int at = rng.bounded(count);
+    switch (rng.bounded(3)) {
+        case 0:
+            tokens.remove(at);
+            break;
+        case 1: {
+            const Token copy = tokens[at];
+            tokens.insert(at, copy);
+            break;
+        }
+        default:
+            if (at + 1 < count) std::swap(tokens[at], tokens[at + 1]);
+            break;
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef PARSERCHECK_H
+#define PARSERCHECK_H
+
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QVector>
+#include "token.h"
+#include "lineindex.h"
+
+/**
+ * @class ParserCheck
+ * @brief 递归下降分析器 Parser 与 LALR 分析器 LalrParser 的差分检查。
+ *
+ * 对同一 Token 序列分别运行两个分析器（均开启语义检查与四元式生成），要求：
+ * - 两者对是否存在语法错误的判断一致；
+ * - 没有语法错误时，语义错误（种类与位置）逐条相同，生成的四元式逐条相同。
+ * 语法错误的种类与恢复方式两者本来就不同，不做比较。同样的要求也用于比较 Parser 的
+ * 顺序分析 parse() 与每个顶层声明单独成块的并行分析 parseParallel(1)。
+ *
+ * 输入可以是命令行给出的源文件，也可以是按文法随机生成的程序，其中一部分再随机
+ * 删除、复制或交换 Token 制造语法错误；另外固定检查几种深度嵌套的程序，要求
+ * Parser 报告嵌套过深而 LalrParser 正常完成。通过 --check-parsers 启动。
+ */
+class ParserCheck
+{
+public:
+    /**
+     * @brief 构造差分检查。
+     * @param arguments --check-parsers 之后的命令行参数：源文件路径，以及可选的
+     *        --random N（随机程序个数，未给出源文件时默认 2000）、--seed S（随机种子）。
+     */
+    explicit ParserCheck(const QStringList &arguments);
+
+    /**
+     * @brief 运行全部检查并输出结果。
+     * @return 进程退出码：全部一致时为 0。
+     */
+    int run();
+
+private:
+    /**
+     * @brief 比较两个分析器以及 Parser 的并行分析对同一 Token 序列的结果，并累计两个分析器的分析耗时。
+     * @param tokens 以 EOF_TOKEN 结尾的 Token 序列。
+     * @param lines 源代码的行首索引，用于描述差异的位置；可为空。
+     * @return 第一处差异的描述，完全一致时为空。
+     */
+    QString compare(const QVector<Token> &tokens, const LineIndex *lines);
+
+    /**
+     * @brief 检查一个源文件，经过与编译流水线相同的扫描与预处理。
+     * @return 第一处差异的描述，一致时为空。
+     */
+    QString checkFile(const QString &path);
+
+    /**
+     * @brief 检查深度嵌套的程序。
+     * @return 第一处问题的描述，全部通过时为空。
+     */
+    QString checkDeepNesting();
+
+    /**
+     * @brief 检查顶层声明头出错时，并行分析登记的全局名字与顺序分析一致。
+     *
+     * 随机程序有语法错误时不比较语义错误，这几段程序的错误恢复不跨越顶层声明，
+     * 两种分析方式的全部错误应逐条相同。
+     * @return 第一处问题的描述，全部通过时为空。
+     */
+    QString checkBrokenDeclarations();
+
+    /**
+     * @brief 随机生成一个语法正确的程序。
+     */
+    QString randomProgram();
+
+    void randomDeclaration(QString &out, int depth);
+    void randomStatement(QString &out, int depth);
+    void randomExpression(QString &out, int depth);
+
+    /**
+     * @brief 随机删除、复制或交换一个 Token，EOF_TOKEN 保持在末尾。
+     */
+    void mutate(QVector<Token> &tokens);
+
+    static constexpr int MAX_DEPTH = 4;        ///< 随机程序的最大嵌套深度。
+    static constexpr int DEEP_NESTING = 100000; ///< 深度嵌套检查的嵌套层数。
+
+    QStringList paths;      ///< 要检查的源文件。
+    int randomCount;        ///< 随机程序的个数。
+    QRandomGenerator rng;   ///< 随机程序生成器。
+    int skipped;            ///< Parser 嵌套过深、未能比较的程序数。
+    qint64 tokenCount;      ///< 已比较的 Token 总数。
+    qint64 recursiveNs;     ///< Parser 的累计分析耗时。
+    qint64 lalrNs;          ///< LalrParser 的累计分析耗时。
+};
+
+#endif // PARSERCHECK_H
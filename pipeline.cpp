@@ -0,0 +1,206 @@
+#include "pipeline.h"
+#include "scanner.h"
+#include "parser.h"
+#include "lalrparser.h"
+#include "quad.h"
+#include "preprocessor.h"
+
+CompilePipeline::CompilePipeline(CompileScheduler *scheduler, QObject *parent)
+    : QObject(parent), current(0), scheduler(scheduler), preempted(false)
+{
+    qRegisterMetaType<QVector<Token>>("QVector<Token>");
+    qRegisterMetaType<LineIndex>("LineIndex");
+    qRegisterMetaType<ScanResult>("ScanResult");
+}
+
+CompilePipeline::~CompilePipeline()
+{
+    cancel();
+    scheduler->withdraw(this);
+}
+
+void CompilePipeline::setText(const QString &source)
+{
+    QMutexLocker locker(&pendingMutex);
+    edits = {TextEdit{0, -1, source}};
+}
+
+void CompilePipeline::edit(int position, int removed, const QString &added)
+{
+    QMutexLocker locker(&pendingMutex);
+    edits.append(TextEdit{position, removed, added});
+}
+
+int CompilePipeline::start()
+{
+    const int generation = current.fetchAndAddOrdered(1) + 1;
+    {
+        // 只保留最新一代；还没开始的旧任务直接被替换，但它的编辑仍须先于新编辑应用
+        QMutexLocker locker(&pendingMutex);
+        QVector<TextEdit> jobEdits = pending ? std::move(pending->edits) : QVector<TextEdit>();
+        jobEdits += edits;
+        edits.clear();
+        pending = Job{generation, std::move(jobEdits), includePaths};
+    }
+    scheduler->submit(this);
+    return generation;
+}
+
+void CompilePipeline::retire()
+{
+    cancel();
+    // 已排队但未送达的结果随接收方一起丢弃，此后不再发出新的结果
+    disconnect();
+    scheduler->retire(this);
+}
+
+void CompilePipeline::cancel()
+{
+    current.fetchAndAddOrdered(1);
+}
+
+int CompilePipeline::generation() const
+{
+    return current.loadAcquire();
+}
+
+void CompilePipeline::setIncludePaths(const QStringList &paths)
+{
+    includePaths = paths;
+}
+
+bool CompilePipeline::isCancelled(int generation) const
+{
+    return generation != current.loadAcquire();
+}
+
+bool CompilePipeline::shouldStop(int generation)
+{
+    if (isCancelled(generation)) return true;
+    preempted = scheduler->shouldYield(this);
+    return preempted;
+}
+
+void CompilePipeline::runPending()
+{
+    std::optional<Job> job;
+    {
+        QMutexLocker locker(&pendingMutex);
+        job.swap(pending);
+    }
+    if (!job) return;
+
+    // 即使这一代已被取消也要应用编辑，之后各代的编辑都以此为基础
+    for (const TextEdit &edit : job->edits) {
+        if (edit.removed < 0) {
+            text = edit.added;
+        } else {
+            text.replace(edit.position, edit.removed, edit.added);
+        }
+    }
+    job->edits.clear();
+
+    preempted = false;
+    run(job->generation, text, job->includePaths);
+    if (!preempted || isCancelled(job->generation)) return;
+
+    // 为前台任务让出了线程：没有更新的任务时把这一代放回去，稍后从头重跑
+    {
+        QMutexLocker locker(&pendingMutex);
+        if (!pending) pending = std::move(job);
+    }
+    scheduler->submit(this);
+}
+
+void CompilePipeline::run(int generation, const QString &source, const QStringList &includePaths)
+{
+    if (shouldStop(generation)) return;
+    const bool foreground = scheduler->isFocused(this);
+
+    // 扫描阶段：前台文档边扫描边按块发布，首块结果无需等待整个文件扫描完成
+    ScanResult scan;
+    scan.lines = LineIndex(source);
+    if (foreground) emit scanStarted(generation, scan.lines);
+    Scanner scanner(source);
+    scanner.setRecordComments(true); // 注释范围供语法高亮共享
+    int published = 0;
+    bool done = false;
+    while (!done) {
+        done = scanner.scanChunk(TOKEN_CHUNK);
+        const QVector<Token> &all = scanner.scannedTokens();
+        if (foreground && all.size() > published) {
+            emit tokensReady(generation, published, all.mid(published));
+            published = all.size();
+        }
+        if (shouldStop(generation)) return;
+    }
+    scan.tokens = scanner.scannedTokens();
+    scan.comments = scanner.comments();
+    emit scanFinished(generation, scan);
+
+    // 预处理阶段：展开宏与头文件，界面上仍显示原始 Token，语法分析使用预处理结果
+    Preprocessor preprocessor;
+    preprocessor.setIncludePaths(includePaths);
+    const QVector<Token> tokens = preprocessor.process(source, scan.tokens);
+    if (shouldStop(generation)) return;
+
+    // 语法分析阶段：同时进行语法制导翻译生成四元式。调度器保证同一条流水线的
+    // 各代任务依次运行，上一代的分析器已析构，内存池可以整体复用。
+    // 前台文档在调度器的线程池上并行分析，后台文档顺序分析
+    arena.reset(source.size());
+    QuadBuilder quads;
+    Parser parser(tokens, &scan.lines, arena.resource());
+    parser.setConsoleOutput(false);
+    parser.setQuadBuilder(&quads);
+    parser.setSemanticChecks(true);
+    parser.setThreadPool(scheduler->threadPool());
+    parser.setCancelCheck([this, generation]() { return isCancelled(generation); });
+    bool parsed = foreground ? parser.parseParallel() : parser.parse();
+    const DiagnosticBuffer *diagnostics = &parser.diagnostics();
+    if (isCancelled(generation)) return;
+
+    // 嵌套过深时递归下降分析器会放弃，改用不递归的 LALR 分析器重新分析
+    std::optional<LalrParser> fallback;
+    if (parser.nestingExceeded()) {
+        quads = QuadBuilder();
+        fallback.emplace(tokens, &scan.lines, arena.resource());
+        fallback->setConsoleOutput(false);
+        fallback->setQuadBuilder(&quads);
+        fallback->setSemanticChecks(true);
+        parsed = fallback->parse();
+        diagnostics = &fallback->diagnostics();
+        if (isCancelled(generation)) return;
+    }
+
+    // 错误信息按块格式化并发布，错误很多时界面也能先显示前面的部分
+    const QStringList preprocessorErrors = preprocessor.formatErrors(scan.lines);
+    const bool ok = parsed && preprocessorErrors.isEmpty();
+    if (ok) {
+        emit diagnosticsReady(generation, QStringList{"语法分析成功！"});
+    } else {
+        if (!preprocessorErrors.isEmpty()) emit diagnosticsReady(generation, preprocessorErrors);
+        const int count = diagnostics->size();
+        for (int first = 0; first < count; first += DIAG_CHUNK) {
+            if (isCancelled(generation)) return;
+            const int last = qMin(count, first + DIAG_CHUNK);
+            emit diagnosticsReady(generation, diagnostics->formatRange(first, last, tokens, &scan.lines));
+        }
+    }
+    emit parseFinished(generation, ok);
+
+    // 中间代码阶段：只有分析成功时四元式才有意义，按块格式化后发布
+    if (ok) {
+        const int count = quads.quads().size();
+        for (int first = 0; first < count; first += QUAD_CHUNK) {
+            if (isCancelled(generation)) return;
+            QStringList chunk;
+            const int last = qMin(count, first + QUAD_CHUNK);
+            for (int i = first; i < last; ++i) {
+                chunk.append(quads.format(i));
+            }
+            emit quadsReady(generation, chunk);
+        }
+    }
+
+    emit finished(generation);
+}
@@ -0,0 +1,207 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QMetaType>
+#include <QMutex>
+#include <QStringList>
+#include <QVector>
+#include <optional>
+#include "token.h"
+#include "lineindex.h"
+#include "scanner.h"
+#include "arena.h"
+#include "scheduler.h"
+
+/**
+ * @brief 后台扫描的结果：Token 列表、注释范围及用于显示行列号的行首索引。
+ */
+struct ScanResult {
+    QVector<Token> tokens;
+    QVector<CommentRange> comments;
+    LineIndex lines;
+};
+
+/**
+ * @brief 界面线程上的一次编辑：把 [position, position + removed) 替换为 added。
+ */
+struct TextEdit {
+    int position;  ///< 起始位置。
+    int removed;   ///< 删除的字符数，为 -1 时用 added 替换整个文本。
+    QString added; ///< 插入的文本。
+};
+
+Q_DECLARE_METATYPE(Token)
+Q_DECLARE_METATYPE(LineIndex)
+Q_DECLARE_METATYPE(ScanResult)
+
+/**
+ * @class CompilePipeline
+ * @brief 分阶段的后台编译流水线：扫描 → 预处理 → 语法分析 → 中间代码 → 显示。
+ *
+ * 流水线在工作线程上持有源代码的副本。界面线程只通过 edit() 记录每次编辑的范围与插入
+ * 的文本，start() 把这些编辑交给新一代任务，由工作线程依次应用后再编译；界面线程上
+ * 因此既不复制整个文档，也不为每次按键移动整段文本。
+ *
+ * 每次 start() 开启一代新的编译任务并使上一代失效。各阶段在工作线程上依次执行，
+ * 阶段之间、每个分块之间及语法分析的顶层声明之间都会检查是否已被取消；结果按块通过信号发布，信号以排队
+ * 方式送达界面线程，界面线程只负责把每块结果填入控件，不会被整次编译阻塞。
+ * 每个信号都带有代号，接收方据此丢弃过期的结果。
+ *
+ * 每个打开的文档各有一条流水线，所有流水线的任务都交给同一个 CompileScheduler
+ * 在共用的线程池上运行。前台文档的任务优先，语法分析也在这个线程池上并行进行；
+ * 后台文档的语法分析顺序进行，并在扫描与阶段之间检查是否应为前台任务让出线程，
+ * 让出的任务稍后从头重跑。
+ * 后台文档不逐块发布 Token，只发布完整的扫描结果。
+ */
+class CompilePipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造流水线。
+     * @param scheduler 运行任务的调度器，须比流水线存活更久。
+     */
+    explicit CompilePipeline(CompileScheduler *scheduler, QObject *parent = nullptr);
+
+    /**
+     * @brief 取消仍在运行的任务，把流水线移出调度器并等待任务退出。
+     *
+     * 会阻塞到任务退出，只在退出程序时直接析构；关闭文档时应调用 retire()。
+     */
+    ~CompilePipeline();
+
+    /**
+     * @brief 取消任务、断开所有信号，由调度器在任务退出后删除流水线，调用方不等待。
+     *
+     * 调用后不得再使用流水线。
+     */
+    void retire();
+
+    /**
+     * @brief 整体替换源代码，从下一次 start() 起生效；尚未交出的编辑随之作废。
+     */
+    void setText(const QString &source);
+
+    /**
+     * @brief 记录一次编辑，从下一次 start() 起生效。
+     * @param position 起始位置。
+     * @param removed 删除的字符数。
+     * @param added 插入的文本。
+     */
+    void edit(int position, int removed, const QString &added);
+
+    /**
+     * @brief 取消上一代任务，对应用了已记录编辑的源代码启动流水线。
+     * @return 本次任务的代号。
+     */
+    int start();
+
+    /**
+     * @brief 取消当前任务，已发出但未处理的结果由接收方按代号丢弃。
+     */
+    void cancel();
+
+    /**
+     * @brief 返回最新一代任务的代号。
+     */
+    int generation() const;
+
+    /**
+     * @brief 设置预处理器的头文件搜索路径，从下一次 start() 起生效。
+     */
+    void setIncludePaths(const QStringList &paths);
+
+    static constexpr int TOKEN_CHUNK = 2048; ///< 每块发布的 Token 数。
+    static constexpr int QUAD_CHUNK = 2048;  ///< 每块发布的四元式条数。
+    static constexpr int DIAG_CHUNK = 256;   ///< 每块发布的错误信息条数。
+
+signals:
+    /**
+     * @brief 扫描阶段开始，给出源代码的行首索引，接收方据此按需换算行列号。
+     * @param generation 任务代号。
+     * @param lines 行首索引。
+     */
+    void scanStarted(int generation, const LineIndex &lines);
+
+    /**
+     * @brief 扫描阶段发布一块 Token。
+     * @param generation 任务代号。
+     * @param firstRow 本块第一个 Token 在完整序列中的下标。
+     * @param tokens 本块的 Token。
+     */
+    void tokensReady(int generation, int firstRow, const QVector<Token> &tokens);
+
+    /**
+     * @brief 扫描阶段结束，给出完整的扫描结果。
+     */
+    void scanFinished(int generation, const ScanResult &result);
+
+    /**
+     * @brief 语法分析阶段发布一块格式化后的信息。
+     * @param messages 成功信息或错误信息，预处理错误在前。
+     */
+    void diagnosticsReady(int generation, const QStringList &messages);
+
+    /**
+     * @brief 语法分析阶段结束，全部信息都已发布。
+     * @param ok 预处理与分析是否都成功。
+     */
+    void parseFinished(int generation, bool ok);
+
+    /**
+     * @brief 中间代码阶段发布一块格式化后的四元式。
+     */
+    void quadsReady(int generation, const QStringList &quads);
+
+    /**
+     * @brief 全部阶段完成。
+     */
+    void finished(int generation);
+
+private:
+    friend class CompileScheduler;
+
+    /**
+     * @brief 一代等待运行的任务。
+     */
+    struct Job {
+        int generation;           ///< 任务代号。
+        QVector<TextEdit> edits;  ///< 运行前须应用到源代码上的编辑。
+        QStringList includePaths; ///< 头文件搜索路径。
+    };
+
+    /**
+     * @brief 由调度器在工作线程上调用，应用编辑后运行最新的一代任务；被抢占时重新排队。
+     */
+    void runPending();
+
+    /**
+     * @brief 在工作线程上依次执行各阶段。
+     */
+    void run(int generation, const QString &source, const QStringList &includePaths);
+
+    /**
+     * @brief 判断指定代号的任务是否已被取消。
+     */
+    bool isCancelled(int generation) const;
+
+    /**
+     * @brief 判断任务是否应在当前检查点停下：已被取消，或须为前台任务让出线程。
+     */
+    bool shouldStop(int generation);
+
+    QAtomicInt current;          ///< 最新一代任务的代号。
+    CompileScheduler *scheduler; ///< 运行任务的调度器。
+    QMutex pendingMutex;         ///< 保护 pending 与 edits。
+    std::optional<Job> pending;  ///< 尚未开始的最新一代任务。
+    QVector<TextEdit> edits;     ///< 尚未交给任务的编辑。
+    QString text;                ///< 源代码，只在工作线程上访问。
+    bool preempted;              ///< 上一次 run() 是否因让出线程而中止，只在工作线程上访问。
+    CompileArena arena;          ///< 编译会话的内存池，每代任务开始时整体释放并复用。
+    QStringList includePaths;    ///< 头文件搜索路径，只在界面线程上访问。
+};
+
+#endif // PIPELINE_H
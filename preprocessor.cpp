@@ -0,0 +1,631 @@
+#include "preprocessor.h"
+#include "scanner.h"
+#include "dfascanner.h"
+#include "sourcetext.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace {
+
+// Token 是否以行首的 '#' 开始一条预处理指令
+bool isDirectiveStart(const SourceFile& file, int i) {
+    if (file.tokens[i].type != TokenType::HASH) return false;
+    return i == 0 || file.lines.lineOf(file.tokens[i - 1].offset) != file.lines.lineOf(file.tokens[i].offset);
+}
+
+// 指令 '#' 所在行之后的第一个 Token 的下标
+int directiveEnd(const SourceFile& file, int hash) {
+    const int line = file.lines.lineOf(file.tokens[hash].offset);
+    const int lineEnd = line < file.lines.lineCount() ? file.lines.offsetAt(line + 1, 1)
+                                                      : static_cast<int>(file.text.size()) + 1;
+    int end = hash + 1;
+    while (file.tokens[end].type != TokenType::EOF_TOKEN && file.tokens[end].offset < lineEnd) ++end;
+    return end;
+}
+
+// 指令名，'#' 之后没有 Token 时为空
+QString directiveName(const SourceFile& file, int begin, int end) {
+    return begin < end ? file.tokens[begin].value : QString();
+}
+
+// 识别 #pragma once 与包住整个文件的包含保护：首条指令为 #ifndef X，
+// 紧接着 #define X，与 #ifndef 配对的 #endif 之后没有任何 Token
+void analyzeGuards(SourceFile& file) {
+    const int count = file.tokens.size() - 1; // 不含 EOF_TOKEN
+    int depth = 0;
+    int guardEnd = -1; // 第一个回到深度 0 的 #endif 所在行之后的下标
+    for (int i = 0; i < count;) {
+        if (!isDirectiveStart(file, i)) {
+            ++i;
+            continue;
+        }
+        const int end = directiveEnd(file, i);
+        const QString name = directiveName(file, i + 1, end);
+        if (name == "pragma" && end - i == 3 && file.tokens[i + 2].value == "once") {
+            file.pragmaOnce = true;
+        } else if (name == "if" || name == "ifdef" || name == "ifndef") {
+            ++depth;
+        } else if (name == "endif" && --depth == 0 && guardEnd < 0) {
+            guardEnd = end;
+        }
+        i = end;
+    }
+
+    if (count == 0 || !isDirectiveStart(file, 0) || guardEnd != count) return;
+    const int first = directiveEnd(file, 0);
+    if (directiveName(file, 1, first) != "ifndef" || first != 3
+        || file.tokens[2].type != TokenType::IDENTIFIER) {
+        return;
+    }
+    if (first >= count || !isDirectiveStart(file, first)) return;
+    const int second = directiveEnd(file, first);
+    if (directiveName(file, first + 1, second) == "define" && second - first >= 3
+        && file.tokens[first + 2].value == file.tokens[2].value) {
+        file.guard = file.tokens[2].value;
+    }
+}
+
+std::shared_ptr<const SourceFile> readSourceFile(const QString& path) {
+    auto file = std::make_shared<SourceFile>();
+    file->path = path;
+    if (!readSourceText(path, file->text)) return nullptr;
+    // 头文件总是整体扫描且不需要注释范围，使用表驱动的 DfaScanner
+    DfaScanner scanner(file->text);
+    scanner.setWarningsEnabled(false);
+    file->tokens = scanner.scanTokens();
+    file->lines = LineIndex(file->text);
+    analyzeGuards(*file);
+    return file;
+}
+
+/**
+ * 计算 #if 条件的整数表达式，运算符与语言本身的表达式相同：
+ * == != < <= > >= + - * / ! 一元负号与括号。剩余的标识符按 C 的规定取 0。
+ */
+class ConditionEvaluator {
+public:
+    explicit ConditionEvaluator(const QVector<Token>& tokens) : tokens(tokens), pos(0), ok(true) {}
+
+    bool evaluate(long long& value) {
+        value = equality();
+        return ok && pos == tokens.size();
+    }
+
+private:
+    bool match(TokenType type) {
+        if (pos < tokens.size() && tokens[pos].type == type) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    long long equality() {
+        long long value = comparison();
+        for (;;) {
+            if (match(TokenType::EQUAL)) value = value == comparison();
+            else if (match(TokenType::NOT_EQUAL)) value = value != comparison();
+            else return value;
+        }
+    }
+
+    long long comparison() {
+        long long value = term();
+        for (;;) {
+            if (match(TokenType::LESS)) value = value < term();
+            else if (match(TokenType::LESS_EQUAL)) value = value <= term();
+            else if (match(TokenType::GREATER)) value = value > term();
+            else if (match(TokenType::GREATER_EQUAL)) value = value >= term();
+            else return value;
+        }
+    }
+
+    long long term() {
+        long long value = factor();
+        for (;;) {
+            if (match(TokenType::PLUS)) value += factor();
+            else if (match(TokenType::MINUS)) value -= factor();
+            else return value;
+        }
+    }
+
+    long long factor() {
+        long long value = unary();
+        for (;;) {
+            if (match(TokenType::MULTIPLY)) {
+                value *= unary();
+            } else if (match(TokenType::DIVIDE)) {
+                const long long divisor = unary();
+                if (divisor == 0) {
+                    ok = false;
+                    return 0;
+                }
+                value /= divisor;
+            } else {
+                return value;
+            }
+        }
+    }
+
+    long long unary() {
+        if (match(TokenType::BANG)) return !unary();
+        if (match(TokenType::MINUS)) return -unary();
+        if (match(TokenType::PLUS)) return unary();
+        return primary();
+    }
+
+    long long primary() {
+        if (match(TokenType::NUMBER)) {
+            bool converted = false;
+            const long long value = tokens[pos - 1].value.toLongLong(&converted);
+            if (!converted) ok = false;
+            return value;
+        }
+        if (pos < tokens.size() && tokens[pos].type >= TokenType::IDENTIFIER
+            && tokens[pos].type <= TokenType::_IMAGINARY && tokens[pos].type != TokenType::HEADER_NAME) {
+            ++pos;
+            return 0;
+        }
+        if (match(TokenType::LEFT_PAREN)) {
+            const long long value = equality();
+            if (!match(TokenType::RIGHT_PAREN)) ok = false;
+            return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    const QVector<Token>& tokens;
+    int pos;
+    bool ok;
+};
+
+} // namespace
+
+HeaderCache& HeaderCache::instance() {
+    static HeaderCache cache;
+    return cache;
+}
+
+std::shared_ptr<const SourceFile> HeaderCache::load(const QString& path) {
+    const QFileInfo info(path);
+    std::shared_ptr<Entry> entry;
+    {
+        QMutexLocker locker(&mutex);
+        entry = entries.value(path);
+        if (!entry || entry->modified != info.lastModified() || entry->size != info.size()) {
+            entry = std::make_shared<Entry>();
+            entry->modified = info.lastModified();
+            entry->size = info.size();
+            entries.insert(path, entry);
+        }
+    }
+    // 扫描在锁外进行，不同头文件可以并行扫描
+    std::call_once(entry->once, [&]() { entry->file = readSourceFile(path); });
+    return entry->file;
+}
+
+Preprocessor::Preprocessor(const QString& fileName)
+    : fileName(fileName) {}
+
+void Preprocessor::setIncludePaths(const QStringList& paths) {
+    includePaths = paths;
+}
+
+void Preprocessor::define(const QString& name, const QString& value) {
+    Scanner scanner(value);
+    scanner.setWarningsEnabled(false);
+    Macro macro;
+    macro.body = scanner.scanTokens();
+    macro.body.removeLast(); // EOF_TOKEN
+    predefined.insert(name, macro);
+}
+
+const QVector<TokenOrigin>& Preprocessor::origins() const {
+    return outputOrigins;
+}
+
+const QStringList& Preprocessor::files() const {
+    return fileList;
+}
+
+const QVector<PreprocessorError>& Preprocessor::errors() const {
+    return errorList;
+}
+
+QStringList Preprocessor::formatErrors(const LineIndex& lines) const {
+    QStringList messages;
+    for (const PreprocessorError& error : errorList) {
+        const SourceLocation loc = lines.locate(error.offset);
+        messages.append(QString("预处理错误 [行 %1, 列 %2]: %3").arg(loc.line).arg(loc.column).arg(error.message));
+    }
+    return messages;
+}
+
+QVector<Token> Preprocessor::process(const QString& source, const QVector<Token>& tokens) {
+    output.clear();
+    outputOrigins.clear();
+    errorList.clear();
+    onceFiles.clear();
+    fileIds.clear();
+    fileList = QStringList{fileName};
+    macros = predefined;
+
+    // 没有指令也没有预定义宏时 Token 原样输出
+    const bool hasDirective = std::any_of(tokens.begin(), tokens.end(), [](const Token& token) {
+        return token.type == TokenType::HASH;
+    });
+    if (!hasDirective && macros.isEmpty()) {
+        outputOrigins.reserve(tokens.size());
+        for (const Token& token : tokens) outputOrigins.append({0, token.offset});
+        output = tokens;
+        return output;
+    }
+
+    SourceFile main;
+    main.path = fileName;
+    main.text = source;
+    main.tokens = tokens;
+    main.lines = LineIndex(source);
+
+    output.reserve(tokens.size());
+    outputOrigins.reserve(tokens.size());
+    processFile(main, 0, -1, 0);
+    output.append(Token(TokenType::EOF_TOKEN, "", source.size()));
+    outputOrigins.append({0, static_cast<int>(source.size())});
+    return output;
+}
+
+void Preprocessor::processFile(const SourceFile& file, int fileId, int site, int depth) {
+    QVector<Conditional> conditionals;
+    QVector<Pending> run; // 相邻指令之间的普通 Token，整段一起展开，使宏实参可以跨行
+    const int count = file.tokens.size() - 1; // 不含 EOF_TOKEN
+    for (int i = 0; i < count;) {
+        if (isDirectiveStart(file, i)) {
+            flush(run);
+            const int end = directiveEnd(file, i);
+            directive(file, fileId, site, i + 1, end, conditionals, depth);
+            i = end;
+            continue;
+        }
+        if (conditionals.isEmpty() || conditionals.last().active) {
+            const Token& token = file.tokens[i];
+            run.append({Token(token.type, token.value, site >= 0 ? site : token.offset),
+                        {fileId, token.offset}, false});
+        }
+        ++i;
+    }
+    flush(run);
+    if (!conditionals.isEmpty()) {
+        report(file, site, static_cast<int>(file.text.size()), "条件编译缺少 #endif");
+    }
+}
+
+void Preprocessor::directive(const SourceFile& file, int fileId, int site, int begin, int end,
+                             QVector<Conditional>& conditionals, int depth) {
+    if (begin == end) return; // 空指令
+    const QString name = directiveName(file, begin, end);
+    const int offset = file.tokens[begin].offset;
+    const bool active = conditionals.isEmpty() || conditionals.last().active;
+
+    // 条件编译指令在无效区域中也要处理，以维持嵌套关系
+    if (name == "ifdef" || name == "ifndef" || name == "if") {
+        bool condition = false;
+        if (active) {
+            if (name == "if") {
+                condition = evaluate(file, fileId, site, begin + 1, end);
+            } else if (end - begin != 2 || file.tokens[begin + 1].type != TokenType::IDENTIFIER) {
+                report(file, site, offset, QString("#%1 需要一个宏名").arg(name));
+            } else {
+                condition = macros.contains(file.tokens[begin + 1].value) == (name == "ifdef");
+            }
+        }
+        conditionals.append({active, condition || !active, active && condition, false});
+        return;
+    }
+    if (name == "elif" || name == "else" || name == "endif") {
+        if (conditionals.isEmpty()) {
+            report(file, site, offset, QString("#%1 没有对应的 #if").arg(name));
+            return;
+        }
+        Conditional& top = conditionals.last();
+        if (name == "endif") {
+            conditionals.removeLast();
+        } else if (top.sawElse) {
+            report(file, site, offset, QString("#%1 出现在 #else 之后").arg(name));
+            top.active = false;
+        } else if (name == "else") {
+            top.active = top.parentActive && !top.taken;
+            top.taken = true;
+            top.sawElse = true;
+        } else {
+            top.active = top.parentActive && !top.taken && evaluate(file, fileId, site, begin + 1, end);
+            top.taken = top.taken || top.active;
+        }
+        return;
+    }
+    if (!active) return;
+
+    if (name == "define") {
+        defineMacro(file, fileId, site, begin, end);
+    } else if (name == "undef") {
+        if (end - begin != 2 || file.tokens[begin + 1].type != TokenType::IDENTIFIER) {
+            report(file, site, offset, "#undef 需要一个宏名");
+            return;
+        }
+        macros.remove(file.tokens[begin + 1].value);
+    } else if (name == "include") {
+        include(file, site, begin, end, depth);
+    } else if (name == "pragma") {
+        if (end - begin >= 2 && file.tokens[begin + 1].value == "once") {
+            onceFiles.insert(file.path);
+        }
+        // 其他 #pragma 忽略
+    } else if (name == "error") {
+        const int from = end - begin >= 2 ? file.tokens[begin + 1].offset : offset + name.size();
+        const int to = file.tokens[end - 1].offset + file.tokens[end - 1].value.size();
+        report(file, site, offset, QString("#error %1").arg(file.text.mid(from, to - from)));
+    } else {
+        report(file, site, offset, QString("未知的预处理指令 #%1").arg(name));
+    }
+}
+
+void Preprocessor::include(const SourceFile& file, int site, int begin, int end, int depth) {
+    const int offset = file.tokens[begin].offset;
+    if (end - begin != 2 || file.tokens[begin + 1].type != TokenType::HEADER_NAME) {
+        report(file, site, offset, "#include 需要 \"file\" 或 <file> 形式的文件名");
+        return;
+    }
+    const QString spelled = file.tokens[begin + 1].value;
+    const QString name = spelled.mid(1, spelled.size() - 2);
+    const QString path = resolve(name, spelled.startsWith('"'), file.path);
+    if (path.isEmpty()) {
+        report(file, site, offset, QString("找不到头文件 %1").arg(spelled));
+        return;
+    }
+    if (depth >= MAX_INCLUDE_DEPTH) {
+        report(file, site, offset, QString("包含层数超过 %1，可能存在循环包含").arg(MAX_INCLUDE_DEPTH));
+        return;
+    }
+
+    const std::shared_ptr<const SourceFile> header = HeaderCache::instance().load(path);
+    if (!header) {
+        report(file, site, offset, QString("无法读取头文件 %1").arg(path));
+        return;
+    }
+    // 已包含过的受保护头文件整体跳过
+    if (header->pragmaOnce && onceFiles.contains(path)) return;
+    if (!header->guard.isEmpty() && macros.contains(header->guard)) return;
+
+    int id = fileIds.value(path, -1);
+    if (id < 0) {
+        id = fileList.size();
+        fileIds.insert(path, id);
+        fileList.append(path);
+    }
+    // 头文件中的 Token 在主文件中都定位到最外层的 #include 处
+    const int includeSite = site >= 0 ? site : file.tokens[begin - 1].offset;
+    processFile(*header, id, includeSite, depth + 1);
+}
+
+void Preprocessor::defineMacro(const SourceFile& file, int fileId, int site, int begin, int end) {
+    if (end - begin < 2 || file.tokens[begin + 1].type != TokenType::IDENTIFIER) {
+        report(file, site, file.tokens[begin].offset, "#define 需要一个宏名");
+        return;
+    }
+    const Token& name = file.tokens[begin + 1];
+    Macro macro;
+    macro.file = fileId;
+    int body = begin + 2;
+
+    // 宏名之后紧跟 '('（中间无空白）才是函数式宏
+    if (body < end && file.tokens[body].type == TokenType::LEFT_PAREN
+        && file.tokens[body].offset == name.offset + name.value.size()) {
+        macro.functionLike = true;
+        ++body;
+        bool expectParam = true;
+        for (;; ++body) {
+            if (body >= end) {
+                report(file, site, name.offset, QString("宏 %1 的形参列表缺少右括号").arg(name.value));
+                return;
+            }
+            const Token& token = file.tokens[body];
+            if (token.type == TokenType::RIGHT_PAREN && (!expectParam || macro.params.isEmpty())) {
+                ++body;
+                break;
+            }
+            if (expectParam && token.type == TokenType::IDENTIFIER) {
+                macro.params.append(token.value);
+                expectParam = false;
+            } else if (!expectParam && token.type == TokenType::COMMA) {
+                expectParam = true;
+            } else {
+                report(file, site, token.offset, QString("宏 %1 的形参列表无效").arg(name.value));
+                return;
+            }
+        }
+    }
+
+    macro.body.reserve(end - body);
+    for (int i = body; i < end; ++i) macro.body.append(file.tokens[i]);
+    macros.insert(name.value, macro);
+}
+
+bool Preprocessor::evaluate(const SourceFile& file, int fileId, int site, int begin, int end) {
+    // 先处理 defined X 与 defined(X)，再展开其余的宏
+    QVector<Pending> stack;
+    QVector<Pending> reversed;
+    for (int i = begin; i < end; ++i) {
+        const Token& token = file.tokens[i];
+        if (token.value == "defined") {
+            const bool paren = i + 1 < end && file.tokens[i + 1].type == TokenType::LEFT_PAREN;
+            const int nameIndex = paren ? i + 2 : i + 1;
+            if (nameIndex >= end || file.tokens[nameIndex].type != TokenType::IDENTIFIER
+                || (paren && (nameIndex + 1 >= end || file.tokens[nameIndex + 1].type != TokenType::RIGHT_PAREN))) {
+                report(file, site, token.offset, "defined 需要一个宏名");
+                return false;
+            }
+            const QString value = macros.contains(file.tokens[nameIndex].value) ? "1" : "0";
+            reversed.append({Token(TokenType::NUMBER, value, token.offset), {fileId, token.offset}, false});
+            i = paren ? nameIndex + 1 : nameIndex;
+            continue;
+        }
+        reversed.append({token, {fileId, token.offset}, false});
+    }
+    for (int i = reversed.size() - 1; i >= 0; --i) stack.append(reversed[i]);
+
+    QVector<Pending> expanded;
+    QStringList active;
+    expand(stack, expanded, active);
+
+    QVector<Token> tokens;
+    tokens.reserve(expanded.size());
+    for (const Pending& item : expanded) tokens.append(item.token);
+    long long value = 0;
+    if (tokens.isEmpty() || !ConditionEvaluator(tokens).evaluate(value)) {
+        report(file, site, file.tokens[begin - 1].offset, "#if 的条件不是有效的整数常量表达式");
+        return false;
+    }
+    return value != 0;
+}
+
+void Preprocessor::flush(QVector<Pending>& run) {
+    if (run.isEmpty()) return;
+    QVector<Pending> stack;
+    stack.reserve(run.size());
+    for (int i = run.size() - 1; i >= 0; --i) stack.append(run[i]);
+    run.clear();
+
+    QVector<Pending> expanded;
+    QStringList active;
+    expand(stack, expanded, active);
+    for (const Pending& item : expanded) {
+        output.append(item.token);
+        outputOrigins.append(item.origin);
+    }
+}
+
+void Preprocessor::expand(QVector<Pending>& stack, QVector<Pending>& out, QStringList& active) {
+    while (!stack.isEmpty()) {
+        Pending item = stack.takeLast();
+        if (item.endOfMacro) {
+            active.removeAt(active.lastIndexOf(item.token.value));
+            continue;
+        }
+        if (item.token.type != TokenType::IDENTIFIER || active.contains(item.token.value)) {
+            out.append(item);
+            continue;
+        }
+        const auto found = macros.constFind(item.token.value);
+        if (found == macros.constEnd()) {
+            out.append(item);
+            continue;
+        }
+        const Macro& macro = found.value();
+        const int site = item.token.offset;
+
+        QVector<QVector<Pending>> args;
+        if (macro.functionLike) {
+            const int collected = collectArguments(stack, active, args);
+            if (collected < 0) { // 没有 '('，只是普通标识符
+                out.append(item);
+                continue;
+            }
+            if (collected == 0) {
+                errorList.append({site, QString("宏 %1 的调用缺少右括号").arg(item.token.value)});
+                continue;
+            }
+            if (macro.params.isEmpty() && args.size() == 1 && args[0].isEmpty()) args.clear();
+            if (args.size() != macro.params.size()) {
+                errorList.append({site, QString("宏 %1 需要 %2 个参数，实际为 %3 个")
+                                        .arg(item.token.value).arg(macro.params.size()).arg(args.size())});
+                continue;
+            }
+            // 实参先完整展开，再代入替换列表
+            for (QVector<Pending>& arg : args) {
+                QVector<Pending> argStack;
+                argStack.reserve(arg.size());
+                for (int i = arg.size() - 1; i >= 0; --i) argStack.append(arg[i]);
+                QVector<Pending> expanded;
+                QStringList argActive = active;
+                expand(argStack, expanded, argActive);
+                arg = expanded;
+            }
+        }
+
+        // 替换列表逆序压栈后重新扫描；结束标记出栈前该宏不再展开
+        stack.append({Token(TokenType::IDENTIFIER, item.token.value, site), item.origin, true});
+        for (int b = macro.body.size() - 1; b >= 0; --b) {
+            const Token& token = macro.body[b];
+            const int param = macro.functionLike && token.type == TokenType::IDENTIFIER
+                              ? macro.params.indexOf(token.value) : -1;
+            if (param >= 0) {
+                const QVector<Pending>& arg = args[param];
+                for (int k = arg.size() - 1; k >= 0; --k) {
+                    Pending substituted = arg[k];
+                    substituted.token.offset = site;
+                    stack.append(substituted);
+                }
+            } else {
+                stack.append({Token(token.type, token.value, site), {macro.file, token.offset}, false});
+            }
+        }
+        active.append(item.token.value);
+    }
+}
+
+int Preprocessor::collectArguments(QVector<Pending>& stack, QStringList& active,
+                                   QVector<QVector<Pending>>& args) {
+    // 越过结束标记查看下一个 Token 是否为 '('
+    int next = stack.size() - 1;
+    while (next >= 0 && stack[next].endOfMacro) --next;
+    if (next < 0 || stack[next].token.type != TokenType::LEFT_PAREN) return -1;
+
+    args.append(QVector<Pending>());
+    int depth = 0;
+    bool opened = false;
+    while (!stack.isEmpty()) {
+        Pending item = stack.takeLast();
+        if (item.endOfMacro) {
+            active.removeAt(active.lastIndexOf(item.token.value));
+            continue;
+        }
+        if (!opened) { // 左括号本身
+            opened = true;
+            continue;
+        }
+        const TokenType type = item.token.type;
+        if (type == TokenType::RIGHT_PAREN && depth == 0) return 1;
+        if (type == TokenType::COMMA && depth == 0) {
+            args.append(QVector<Pending>());
+            continue;
+        }
+        if (type == TokenType::LEFT_PAREN) ++depth;
+        if (type == TokenType::RIGHT_PAREN) --depth;
+        args.last().append(item);
+    }
+    return 0;
+}
+
+QString Preprocessor::resolve(const QString& name, bool quoted, const QString& includer) const {
+    QStringList directories;
+    // 引号形式先在引入者所在目录中查找
+    if (quoted && !includer.isEmpty()) directories.append(QFileInfo(includer).absolutePath());
+    directories.append(includePaths);
+    for (const QString& directory : directories) {
+        const QFileInfo candidate(QDir(directory).filePath(name));
+        if (candidate.isFile()) return candidate.canonicalFilePath();
+    }
+    return QString();
+}
+
+void Preprocessor::report(const SourceFile& file, int site, int offset, const QString& message) {
+    if (site < 0) {
+        errorList.append({offset, message});
+        return;
+    }
+    const SourceLocation loc = file.lines.locate(offset);
+    errorList.append({site, QString("%1:%2: %3").arg(file.path).arg(loc.line).arg(message)});
+}
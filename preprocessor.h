@@ -0,0 +1,253 @@
+#ifndef PREPROCESSOR_H
+#define PREPROCESSOR_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+#include <mutex>
+#include "token.h"
+#include "lineindex.h"
+
+/**
+ * @struct SourceFile
+ * @brief 一个已扫描的源文件：文本、Token 序列以及预先分析出的包含保护信息。
+ */
+struct SourceFile {
+    QString path;            ///< 规范化的绝对路径，主文件可为空。
+    QString text;            ///< 文件内容。
+    QVector<Token> tokens;   ///< 扫描结果，以 EOF_TOKEN 结尾。
+    LineIndex lines;         ///< 行首索引。
+    QString guard;           ///< 包住整个文件的 #ifndef X / #define X ... #endif 中的宏名，没有时为空。
+    bool pragmaOnce = false; ///< 文件中是否有 #pragma once。
+};
+
+/**
+ * @struct TokenOrigin
+ * @brief 预处理输出的 Token 在原始文件中的位置。
+ */
+struct TokenOrigin {
+    int file;   ///< 文件在 Preprocessor::files() 中的下标，0 为主文件，-1 为 define() 预定义的宏。
+    int offset; ///< 在该文件中的偏移量。
+};
+
+/**
+ * @struct PreprocessorError
+ * @brief 一条预处理错误。
+ */
+struct PreprocessorError {
+    int offset;      ///< 主文件中的偏移量；头文件中的错误取引入它的 #include 的位置。
+    QString message; ///< 错误描述，头文件中的错误带有文件名和行号。
+};
+
+/**
+ * @class HeaderCache
+ * @brief 进程内共享的头文件缓存。
+ *
+ * 每个头文件在进程中只读取和扫描一次，结果以 Token 数组的形式保存，供所有编译会话
+ * 与线程共用；文件在磁盘上被修改（时间戳或大小变化）后才重新扫描。
+ * 同时请求同一头文件的线程只有一个真正扫描，其余等待其结果。
+ */
+class HeaderCache {
+public:
+    /**
+     * @brief 返回进程内唯一的缓存。
+     */
+    static HeaderCache& instance();
+
+    /**
+     * @brief 取得头文件的扫描结果，必要时读取并扫描。
+     * @param path 规范化的绝对路径。
+     * @return 扫描结果；文件无法读取时返回空指针。
+     */
+    std::shared_ptr<const SourceFile> load(const QString& path);
+
+private:
+    HeaderCache() = default;
+
+    /**
+     * @brief 一个头文件的缓存项。
+     */
+    struct Entry {
+        QDateTime modified;                     ///< 扫描时文件的修改时间。
+        qint64 size = 0;                        ///< 扫描时文件的大小。
+        std::once_flag once;                    ///< 保证只扫描一次。
+        std::shared_ptr<const SourceFile> file; ///< 扫描结果。
+    };
+
+    QMutex mutex;                                   ///< 保护 entries。
+    QHash<QString, std::shared_ptr<Entry>> entries; ///< 按路径索引的缓存项。
+};
+
+/**
+ * @class Preprocessor
+ * @brief 位于词法分析与语法分析之间的预处理器。
+ *
+ * 支持对象式宏与函数式宏（#define、#undef）、#include 及其搜索路径、
+ * #if/#ifdef/#ifndef/#elif/#else/#endif 条件编译、#pragma once 与 #error。
+ * 头文件从 HeaderCache 取得已扫描好的 Token 数组；带有包含保护或 #pragma once 的头文件
+ * 第二次被包含时直接跳过，既不重新扫描也不再逐个 Token 处理。
+ *
+ * 宏展开只复制 Token，Token 文本是隐式共享的 QString，不会被重新拷贝。
+ * 输出 Token 的 offset 都换算到主文件中：来自宏展开的 Token 取宏调用处的位置，
+ * 来自头文件的 Token 取 #include 的位置，因此语法分析的错误位置总能在主文件中显示；
+ * 精确的来源见 origins()。不支持 # 与 ## 运算符和反斜杠续行。
+ */
+class Preprocessor {
+public:
+    /**
+     * @brief 构造预处理器。
+     * @param fileName 主文件的路径，用于查找以引号包含的头文件；可为空。
+     */
+    explicit Preprocessor(const QString& fileName = QString());
+
+    /**
+     * @brief 设置头文件搜索路径，按顺序查找。
+     */
+    void setIncludePaths(const QStringList& paths);
+
+    /**
+     * @brief 预定义一个对象式宏，相当于命令行的 -D。
+     * @param name 宏名。
+     * @param value 宏的替换文本。
+     */
+    void define(const QString& name, const QString& value = "1");
+
+    /**
+     * @brief 对主文件进行预处理。
+     * @param source 主文件的源代码。
+     * @param tokens 主文件的扫描结果，以 EOF_TOKEN 结尾。
+     * @return 预处理后的 Token 序列，以 EOF_TOKEN 结尾。
+     */
+    QVector<Token> process(const QString& source, const QVector<Token>& tokens);
+
+    /**
+     * @brief 返回与 process() 的结果一一对应的 Token 来源。
+     */
+    const QVector<TokenOrigin>& origins() const;
+
+    /**
+     * @brief 返回参与预处理的文件，第 0 项为主文件。
+     */
+    const QStringList& files() const;
+
+    /**
+     * @brief 返回预处理过程中的错误。
+     */
+    const QVector<PreprocessorError>& errors() const;
+
+    /**
+     * @brief 把所有错误格式化为带行列号的文本。
+     * @param lines 主文件的行首索引。
+     */
+    QStringList formatErrors(const LineIndex& lines) const;
+
+private:
+    /**
+     * @brief 一个宏定义。
+     */
+    struct Macro {
+        bool functionLike = false; ///< 是否为函数式宏。
+        QStringList params;        ///< 形参名。
+        QVector<Token> body;       ///< 替换列表，offset 为定义所在文件中的位置。
+        int file = -1;             ///< 定义所在的文件。
+    };
+
+    /**
+     * @brief 等待展开或已展开的 Token。
+     */
+    struct Pending {
+        Token token;             ///< Token，offset 已换算到主文件。
+        TokenOrigin origin;      ///< Token 的来源。
+        bool endOfMacro = false; ///< 是否为宏替换结束的标记，此时 token.value 为宏名。
+    };
+
+    /**
+     * @brief 一层条件编译。
+     */
+    struct Conditional {
+        bool parentActive; ///< 外层是否处于有效区域。
+        bool taken;        ///< 是否已有分支被选中。
+        bool active;       ///< 当前分支是否有效。
+        bool sawElse;      ///< 是否已遇到 #else。
+    };
+
+    /**
+     * @brief 处理一个文件的全部 Token。
+     * @param site 该文件在主文件中的引入位置，主文件为 -1。
+     * @param depth 包含嵌套深度。
+     */
+    void processFile(const SourceFile& file, int fileId, int site, int depth);
+
+    /**
+     * @brief 处理一条预处理指令，[begin, end) 为 '#' 之后到行末的 Token。
+     */
+    void directive(const SourceFile& file, int fileId, int site, int begin, int end,
+                   QVector<Conditional>& conditionals, int depth);
+
+    /**
+     * @brief 处理 #include 指令。
+     */
+    void include(const SourceFile& file, int site, int begin, int end, int depth);
+
+    /**
+     * @brief 处理 #define 指令。
+     */
+    void defineMacro(const SourceFile& file, int fileId, int site, int begin, int end);
+
+    /**
+     * @brief 计算 #if/#elif 的条件。
+     */
+    bool evaluate(const SourceFile& file, int fileId, int site, int begin, int end);
+
+    /**
+     * @brief 展开一段普通 Token 并追加到输出。
+     */
+    void flush(QVector<Pending>& run);
+
+    /**
+     * @brief 宏展开。
+     * @param stack 待处理的 Token，逆序存放，栈顶为下一个 Token。
+     * @param out 展开结果。
+     * @param active 正在展开的宏，展开期间不再展开同名宏。
+     */
+    void expand(QVector<Pending>& stack, QVector<Pending>& out, QStringList& active);
+
+    /**
+     * @brief 收集函数式宏调用的实参。
+     * @return 后面没有 '(' 时返回 -1（不是调用），缺少 ')' 时返回 0，成功返回 1。
+     */
+    int collectArguments(QVector<Pending>& stack, QStringList& active,
+                         QVector<QVector<Pending>>& args);
+
+    /**
+     * @brief 在头文件搜索路径中查找头文件。
+     * @return 规范化的绝对路径，找不到时为空。
+     */
+    QString resolve(const QString& name, bool quoted, const QString& includer) const;
+
+    /**
+     * @brief 记录一条错误。
+     * @param offset 错误在所在文件中的偏移量。
+     */
+    void report(const SourceFile& file, int site, int offset, const QString& message);
+
+    static constexpr int MAX_INCLUDE_DEPTH = 200; ///< 最大包含深度，防止循环包含。
+
+    QString fileName;                     ///< 主文件路径。
+    QStringList includePaths;             ///< 头文件搜索路径。
+    QHash<QString, Macro> predefined;     ///< define() 预定义的宏，每次预处理开始时复制到 macros。
+    QHash<QString, Macro> macros;         ///< 当前定义的宏。
+    QSet<QString> onceFiles;              ///< 已包含过的 #pragma once 文件。
+    QHash<QString, int> fileIds;          ///< 文件路径到 files 下标的映射。
+    QStringList fileList;                 ///< 参与预处理的文件。
+    QVector<Token> output;                ///< 预处理结果。
+    QVector<TokenOrigin> outputOrigins;   ///< 预处理结果的来源。
+    QVector<PreprocessorError> errorList; ///< 错误。
+};
+
+#endif // PREPROCESSOR_H
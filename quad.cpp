@@ -0,0 +1,125 @@
+#include "quad.h"
+
+Operand Operand::name(const QString& text) {
+    Operand o;
+    o.kind = OperandKind::NAME;
+    o.text = text;
+    return o;
+}
+
+Operand Operand::constant(const QString& text) {
+    Operand o;
+    o.kind = OperandKind::CONST;
+    o.text = text;
+    return o;
+}
+
+Operand Operand::temp(int id) {
+    Operand o;
+    o.kind = OperandKind::TEMP;
+    o.id = id;
+    return o;
+}
+
+Operand Operand::label(int target) {
+    Operand o;
+    o.kind = OperandKind::LABEL;
+    o.id = target;
+    return o;
+}
+
+QString Operand::toString() const {
+    switch (kind) {
+        case OperandKind::NAME:
+        case OperandKind::CONST: return text;
+        case OperandKind::TEMP:  return QString("t%1").arg(id);
+        case OperandKind::LABEL: return QString("(%1)").arg(id);
+        case OperandKind::NONE:  break;
+    }
+    return "_";
+}
+
+QString getQuadOpString(QuadOp op) {
+    switch (op) {
+        case QuadOp::ADD:    return "+";
+        case QuadOp::SUB:    return "-";
+        case QuadOp::MUL:    return "*";
+        case QuadOp::DIV:    return "/";
+        case QuadOp::NEG:    return "neg";
+        case QuadOp::NOT:    return "!";
+        case QuadOp::LT:     return "<";
+        case QuadOp::LE:     return "<=";
+        case QuadOp::GT:     return ">";
+        case QuadOp::GE:     return ">=";
+        case QuadOp::EQ:     return "==";
+        case QuadOp::NE:     return "!=";
+        case QuadOp::ASSIGN: return "=";
+        case QuadOp::JZ:     return "jz";
+        case QuadOp::JMP:    return "j";
+        case QuadOp::FUNC:   return "func";
+        case QuadOp::RETURN: return "ret";
+    }
+    return "?";
+}
+
+QuadOp binaryQuadOp(TokenType op) {
+    switch (op) {
+        case TokenType::PLUS:          return QuadOp::ADD;
+        case TokenType::MINUS:         return QuadOp::SUB;
+        case TokenType::MULTIPLY:      return QuadOp::MUL;
+        case TokenType::DIVIDE:        return QuadOp::DIV;
+        case TokenType::LESS:          return QuadOp::LT;
+        case TokenType::LESS_EQUAL:    return QuadOp::LE;
+        case TokenType::GREATER:       return QuadOp::GT;
+        case TokenType::GREATER_EQUAL: return QuadOp::GE;
+        case TokenType::EQUAL:         return QuadOp::EQ;
+        default:                       return QuadOp::NE;
+    }
+}
+
+int QuadBuilder::emitQuad(QuadOp op, const Operand& arg1, const Operand& arg2, const Operand& result) {
+    code.append({op, arg1, arg2, result});
+    return code.size() - 1;
+}
+
+Operand QuadBuilder::newTemp() {
+    return Operand::temp(++tempCount);
+}
+
+int QuadBuilder::nextIndex() const {
+    return code.size();
+}
+
+void QuadBuilder::patch(int index, int target) {
+    code[index].result = Operand::label(target);
+}
+
+void QuadBuilder::append(const QuadBuilder& other) {
+    const int base = code.size();
+    auto shift = [&](Operand& o) {
+        if (o.kind == OperandKind::TEMP) o.id += tempCount;
+        else if (o.kind == OperandKind::LABEL) o.id += base;
+    };
+    code.reserve(base + other.code.size());
+    for (Quad q : other.code) {
+        shift(q.arg1);
+        shift(q.arg2);
+        shift(q.result);
+        code.append(q);
+    }
+    tempCount += other.tempCount;
+}
+
+const QVector<Quad>& QuadBuilder::quads() const {
+    return code;
+}
+
+QString QuadBuilder::format(int i) const {
+    const Quad& q = code[i];
+    return QString("(%1) (%2, %3, %4, %5)")
+           .arg(i)
+           .arg(getQuadOpString(q.op))
+           .arg(q.arg1.toString())
+           .arg(q.arg2.toString())
+           .arg(q.result.toString());
+}
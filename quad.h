@@ -0,0 +1,133 @@
+#ifndef QUAD_H
+#define QUAD_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include "token.h"
+
+/**
+ * @enum QuadOp
+ * @brief 四元式的运算符。
+ */
+enum class QuadOp : quint8 {
+    ADD, SUB, MUL, DIV,     ///< 算术运算：result = arg1 op arg2
+    NEG, NOT,               ///< 一元运算：result = op arg1
+    LT, LE, GT, GE, EQ, NE, ///< 关系运算，结果为 0 或 1
+    ASSIGN,                 ///< 赋值：result = arg1
+    JZ,                     ///< arg1 为 0 时跳转到 result
+    JMP,                    ///< 无条件跳转到 result
+    FUNC,                   ///< 函数入口，arg1 为函数名
+    RETURN                  ///< 返回，arg1 为返回值（可为空）
+};
+
+/**
+ * @enum OperandKind
+ * @brief 四元式操作数的种类。
+ */
+enum class OperandKind : quint8 {
+    NONE,   ///< 空操作数
+    NAME,   ///< 变量或函数名
+    CONST,  ///< 常数
+    TEMP,   ///< 临时变量，编号保存在 id 中
+    LABEL   ///< 跳转目标，四元式下标保存在 id 中
+};
+
+/**
+ * @struct Operand
+ * @brief 四元式的操作数。
+ */
+struct Operand {
+    OperandKind kind = OperandKind::NONE; ///< 操作数种类。
+    int id = 0;                           ///< 临时变量编号或跳转目标下标。
+    QString text;                         ///< 名字或常数的文本。
+
+    /** @brief 构造名字操作数。 */
+    static Operand name(const QString& text);
+    /** @brief 构造常数操作数。 */
+    static Operand constant(const QString& text);
+    /** @brief 构造临时变量操作数。 */
+    static Operand temp(int id);
+    /** @brief 构造跳转目标操作数。 */
+    static Operand label(int target);
+
+    /**
+     * @brief 返回操作数的显示文本，如 "x"、"3"、"t1"、"(5)"，空操作数为 "_"。
+     */
+    QString toString() const;
+};
+
+/**
+ * @struct Quad
+ * @brief 一条四元式 (op, arg1, arg2, result)。
+ */
+struct Quad {
+    QuadOp op;      ///< 运算符。
+    Operand arg1;   ///< 第一个操作数。
+    Operand arg2;   ///< 第二个操作数。
+    Operand result; ///< 结果或跳转目标。
+};
+
+/**
+ * @brief 返回四元式运算符的显示文本。
+ */
+QString getQuadOpString(QuadOp op);
+
+/**
+ * @brief 返回二元运算符 Token 对应的四元式运算符。
+ */
+QuadOp binaryQuadOp(TokenType op);
+
+/**
+ * @class QuadBuilder
+ * @brief 语法制导翻译时用于生成四元式序列的缓冲区。
+ *
+ * 负责分配临时变量编号、追加四元式以及回填跳转目标。
+ */
+class QuadBuilder {
+public:
+    /**
+     * @brief 追加一条四元式。
+     * @return 该四元式的下标，可用于之后回填跳转目标。
+     */
+    int emitQuad(QuadOp op, const Operand& arg1 = Operand(), const Operand& arg2 = Operand(),
+                 const Operand& result = Operand());
+
+    /**
+     * @brief 分配一个新的临时变量。
+     */
+    Operand newTemp();
+
+    /**
+     * @brief 返回下一条四元式将要使用的下标。
+     */
+    int nextIndex() const;
+
+    /**
+     * @brief 回填跳转四元式的目标。
+     * @param index 跳转四元式的下标。
+     * @param target 跳转目标下标。
+     */
+    void patch(int index, int target);
+
+    /**
+     * @brief 把另一段独立生成的四元式接到末尾，临时变量编号与跳转目标随之平移。
+     */
+    void append(const QuadBuilder& other);
+
+    /**
+     * @brief 返回已生成的四元式序列。
+     */
+    const QVector<Quad>& quads() const;
+
+    /**
+     * @brief 返回第 i 条四元式的显示文本，形如 "(5) (+, a, b, t1)"。
+     */
+    QString format(int i) const;
+
+private:
+    QVector<Quad> code;  ///< 四元式序列。
+    int tempCount = 0;   ///< 已分配的临时变量个数。
+};
+
+#endif // QUAD_H
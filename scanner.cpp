@@ -1,20 +1,79 @@
 #include "scanner.h"
+#include "arena.h"
 #include <QDebug>
 #include <cctype>
 
 
 Scanner::Scanner(const QString& source)
-    : source(source), start(0), current(0), line(1) {}
+    : source(source), start(0), current(0), lineIndexBuilt(false),
+      recordComments(false), warningsEnabled(true), startInComment(false), endInComment(false) {
+    tokens.reserve(int(CompileArena::estimateTokens(source.size())));
+}
+
+void Scanner::setRecordComments(bool record) {
+    recordComments = record;
+}
+
+void Scanner::setWarningsEnabled(bool enabled) {
+    warningsEnabled = enabled;
+}
+
+void Scanner::setStartsInComment(bool inComment) {
+    startInComment = inComment;
+}
+
+const QVector<CommentRange>& Scanner::comments() const {
+    return commentRanges;
+}
+
+bool Scanner::endsInComment() const {
+    return endInComment;
+}
 
 QVector<Token> Scanner::scanTokens() {
     while (!isAtEnd()) {
-        start = current;
-        scanToken();
+        scanNext();
+    }
+    finish();
+    return tokens;
+}
+
+bool Scanner::scanChunk(int maxTokens) {
+    const int target = tokens.size() + maxTokens;
+    while (!isAtEnd() && tokens.size() < target) {
+        scanNext();
     }
-    tokens.append(Token(TokenType::EOF_TOKEN, "", line));
+    if (!isAtEnd()) return false;
+    finish();
+    return true;
+}
+
+const QVector<Token>& Scanner::scannedTokens() const {
     return tokens;
 }
 
+void Scanner::scanNext() {
+    start = current;
+    if (startInComment) {
+        // 源码片段从上一段未闭合的多行注释中间开始
+        startInComment = false;
+        blockCommentBody();
+        return;
+    }
+    scanToken();
+}
+
+void Scanner::finish() {
+    if (startInComment) {
+        // 空片段：仍处于上一段的多行注释中
+        startInComment = false;
+        endInComment = true;
+    }
+    if (tokens.isEmpty() || tokens.last().type != TokenType::EOF_TOKEN) {
+        tokens.append(Token(TokenType::EOF_TOKEN, "", current));
+    }
+}
+
 bool Scanner::isAtEnd() const {
     return current >= source.size();
 }
@@ -24,8 +83,18 @@ QChar Scanner::advance() {
 }
 
 void Scanner::addToken(TokenType type) {
-    QString text = source.mid(start, current - start);
-    tokens.append(Token(type, text, line));
+    // 运算符、分隔符和关键字使用静态拼写，不为每个 Token 分配字符串
+    QString text = tokenSpelling(type);
+    if (text.isEmpty()) text = source.mid(start, current - start);
+    tokens.append(Token(type, text, start));
+}
+
+SourceLocation Scanner::locate(int offset) {
+    if (!lineIndexBuilt) {
+        lineIndex = LineIndex(source);
+        lineIndexBuilt = true;
+    }
+    return lineIndex.locate(offset);
 }
 
 QChar Scanner::peek() const {
@@ -83,16 +152,18 @@ void Scanner::scanToken() {
             else addToken(TokenType::BANG);
             break;
         case ';': addToken(TokenType::SEMICOLON); break;
-        case ' ': case '\r': case '\t': break; // 忽略空白字符
-        case '\n': line++; break;
+        case '#': addToken(TokenType::HASH); break;
+        case ' ': case '\r': case '\t': case '\n': break; // 忽略空白字符
 
         default:
             if (c.isDigit()) {
                 number();
             } else if (c.isLetter() || c == '_') {
                 identifier();
-            } else {
-                qWarning() << "Unexpected character '" << c << "' at line" << line;
+            } else if (warningsEnabled) {
+                SourceLocation loc = locate(start);
+                qWarning() << "Unexpected character '" << c << "' at line" << loc.line
+                           << "column" << loc.column;
             }
             break;
     }
@@ -102,53 +173,35 @@ void Scanner::identifier() {
     while (peek().isLetterOrNumber() || peek() == '_') advance();
 
     QString text = source.mid(start, current - start);
+    const TokenType type = lookupKeyword(text);
+    tokens.append(Token(type, type == TokenType::IDENTIFIER ? text : tokenSpelling(type), start));
+
+    if (text == "include") headerName();
+}
 
-    static const QMap<QString, TokenType> keywords = {
-        {"auto", TokenType::AUTO},
-        {"break", TokenType::BREAK},
-        {"case", TokenType::CASE},
-        {"char", TokenType::CHAR},
-        {"const", TokenType::CONST},
-        {"continue", TokenType::CONTINUE},
-        {"default", TokenType::DEFAULT},
-        {"do", TokenType::DO},
-        {"double", TokenType::DOUBLE},
-        {"else", TokenType::ELSE},
-        {"enum", TokenType::ENUM},
-        {"extern", TokenType::EXTERN},
-        {"float", TokenType::FLOAT},
-        {"for", TokenType::FOR},
-        {"goto", TokenType::GOTO},
-        {"if", TokenType::IF},
-        {"inline", TokenType::INLINE},
-        {"int", TokenType::INT},
-        {"long", TokenType::LONG},
-        {"register", TokenType::REGISTER},
-        {"restrict", TokenType::RESTRICT},
-        {"return", TokenType::RETURN},
-        {"short", TokenType::SHORT},
-        {"signed", TokenType::SIGNED},
-        {"sizeof", TokenType::SIZEOF},
-        {"static", TokenType::STATIC},
-        {"struct", TokenType::STRUCT},
-        {"switch", TokenType::SWITCH},
-        {"typedef", TokenType::TYPEDEF},
-        {"union", TokenType::UNION},
-        {"unsigned", TokenType::UNSIGNED},
-        {"void", TokenType::VOID},
-        {"volatile", TokenType::VOLATILE},
-        {"while", TokenType::WHILE},
-        {"_Bool", TokenType::_BOOL},
-        {"_Complex", TokenType::_COMPLEX},
-        {"_Imaginary", TokenType::_IMAGINARY}
-    };
-
-    auto it = keywords.find(text);
-    if (it != keywords.end()) {
-        addToken(it.value());
-    } else {
-        addToken(TokenType::IDENTIFIER);
+void Scanner::headerName() {
+    // 前一个 Token 必须是行首的 '#'
+    const int count = tokens.size();
+    if (count < 2 || tokens[count - 2].type != TokenType::HASH) return;
+    for (int i = tokens[count - 2].offset - 1; i >= 0 && source[i] != '\n'; --i) {
+        if (source[i] != ' ' && source[i] != '\t') return;
     }
+
+    int pos = current;
+    while (pos < source.size() && (source[pos] == ' ' || source[pos] == '\t')) ++pos;
+    if (pos >= source.size()) return;
+    QChar close;
+    if (source[pos] == '"') close = '"';
+    else if (source[pos] == '<') close = '>';
+    else return;
+
+    int end = pos + 1;
+    while (end < source.size() && source[end] != close && source[end] != '\n') ++end;
+    if (end >= source.size() || source[end] != close) return;
+
+    start = pos;
+    current = end + 1;
+    addToken(TokenType::HEADER_NAME);
 }
 
 
@@ -168,31 +221,44 @@ bool Scanner::tryConsumeComment() {
     if (peek() == '/') {
         // 单行注释: 跳过直到换行
         while (peek() != '\n' && !isAtEnd()) advance();
-        // addToken(TokenType::SINGLE_LINE_COMMENT);
+        addComment();
         return true;
     }
     if (peek() == '*') {
         // 多行注释: 跳过直到 '*/'
-        advance(); advance(); // 跳过 '/*'
-
-        bool closed = false;
-        while (!isAtEnd()) {
-            QChar c = advance();
-            if (c == '*' && peek() == '/') {
-                advance(); // 跳过 '/'
-                closed = true;
-                break;
-            }
-            if (c == '\n') line++; // 更新行号
+        advance(); // 跳过 '*'
+        if (!isAtEnd()) advance();
+        blockCommentBody();
+        return true;
+    }
+
+    return false; // 没有识别到注释
+}
+
+void Scanner::blockCommentBody() {
+    bool closed = false;
+    while (!isAtEnd()) {
+        QChar c = advance();
+        if (c == '*' && peek() == '/') {
+            advance(); // 跳过 '/'
+            closed = true;
+            break;
         }
+    }
 
-        if (!closed) {
-            qWarning() << "Unterminated multi-line comment at line" << line;
-        } else {
-            // addToken(TokenType::MULTI_LINE_COMMENT);
+    if (!closed) {
+        endInComment = true;
+        if (warningsEnabled) {
+            SourceLocation loc = locate(start);
+            qWarning() << "Unterminated multi-line comment at line" << loc.line
+                       << "column" << loc.column;
         }
-        return true;
     }
+    addComment();
+}
 
-    return false; // 没有识别到注释
+void Scanner::addComment() {
+    if (recordComments) {
+        commentRanges.append({start, current - start});
+    }
 }
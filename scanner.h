@@ -4,6 +4,16 @@
 #include <QString>
 #include <QVector>
 #include "token.h"
+#include "lineindex.h"
+
+/**
+ * @struct CommentRange
+ * @brief 一段注释在源代码中的范围。
+ */
+struct CommentRange {
+    int offset; ///< 注释首字符的偏移量。
+    int length; ///< 注释长度，未闭合的多行注释延伸到源码末尾。
+};
 
 /**
  * @class Scanner
@@ -26,6 +36,45 @@ public:
      */
     QVector<Token> scanTokens();
 
+    /**
+     * @brief 增量扫描：继续扫描，最多再识别 maxTokens 个 Token 后返回。
+     *
+     * 供后台流水线分块发布结果使用；已识别的 Token 通过 scannedTokens() 获取。
+     * @param maxTokens 本次最多识别的 Token 数。
+     * @return 已扫描到源码末尾（并追加了 EOF_TOKEN）时返回 true。
+     */
+    bool scanChunk(int maxTokens);
+
+    /**
+     * @brief 返回目前为止已识别的 Token。
+     */
+    const QVector<Token>& scannedTokens() const;
+
+    /**
+     * @brief 设置是否记录注释的范围，供语法高亮使用，默认不记录。
+     */
+    void setRecordComments(bool record);
+
+    /**
+     * @brief 设置是否输出非法字符、未闭合注释等警告，默认输出。
+     */
+    void setWarningsEnabled(bool enabled);
+
+    /**
+     * @brief 设置源代码是否从一段未闭合的多行注释中间开始，用于逐行扫描的片段。
+     */
+    void setStartsInComment(bool inComment);
+
+    /**
+     * @brief 返回记录到的注释范围，按出现顺序排列。
+     */
+    const QVector<CommentRange>& comments() const;
+
+    /**
+     * @brief 判断源代码是否在一段未闭合的多行注释中结束。
+     */
+    bool endsInComment() const;
+
 private:
     /**
      * @brief 检查是否到达源代码末尾。
@@ -74,6 +123,13 @@ private:
      */
     void identifier();
 
+    /**
+     * @brief 在行首的 "# include" 之后识别 "file.h" 或 <file.h> 形式的头文件名。
+     *
+     * 头文件名只在这一上下文中是一个 Token；找不到配对的定界符时不做任何事。
+     */
+    void headerName();
+
     /**
      * @brief 处理数字字面量的扫描。
      */
@@ -85,11 +141,46 @@ private:
      */
     bool tryConsumeComment();
 
+    /**
+     * @brief 跳过多行注释的正文直到 '*\/'，未闭合时标记 endsInComment。
+     */
+    void blockCommentBody();
+
+    /**
+     * @brief 若开启了注释记录，记录当前 [start, current) 范围为一段注释。
+     */
+    void addComment();
+
+    /**
+     * @brief 从当前位置开始识别下一个 Token（或跳过空白、注释）。
+     */
+    void scanNext();
+
+    /**
+     * @brief 在 Token 列表末尾追加 EOF_TOKEN（只追加一次）。
+     */
+    void finish();
+
+    /**
+     * @brief 将偏移量换算为行列号，仅在报告错误时使用。
+     *
+     * 行首索引在第一次调用时才构建，无错误的扫描不会产生任何行号统计开销。
+     * @param offset 源代码中的偏移量。
+     * @return 对应的行列位置。
+     */
+    SourceLocation locate(int offset);
+
     const QString source;  ///< 原始源代码字符串。
     int start;             ///< 当前 Token 开始位置索引。
     int current;           ///< 当前扫描位置索引。
-    int line;              ///< 当前所在的行号，用于错误报告。
     QVector<Token> tokens; ///< 存储扫描结果 Token 列表。
+    LineIndex lineIndex;   ///< 按需构建的行首索引，用于错误报告。
+    bool lineIndexBuilt;   ///< 行首索引是否已构建。
+    bool recordComments;   ///< 是否记录注释范围。
+    bool warningsEnabled;  ///< 是否输出警告。
+    bool startInComment;   ///< 是否从多行注释中间开始扫描。
+    bool endInComment;     ///< 是否在未闭合的多行注释中结束。
+    QVector<CommentRange> commentRanges; ///< 记录到的注释范围。
 };
 
 #endif // SCANNER_H
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "scannercheck.h"
+#include "dfascanner.h"
+#include "scanner.h"
+#include "sourcetext.h"
+#include <QElapsedTimer>
+#include <QTextStream>
+
+namespace {
+
+// 未给出源文件时检查的随机源代码个数与默认随机种子
+constexpr int DEFAULT_RANDOM = 20000;
+constexpr quint32 DEFAULT_SEED = 1;
+
+// 随机源代码的片段（UTF-8），刻意包含两个扫描器最容易分歧的边界情况
+const char *const FRAGMENTS[] = {
+    // ASCII 关键字、标识符与数字
+    "int", "float", "char", "if", "else", "return", "while", "include", "x", "_tmp1", "a1b",
+    "0", "42", "3.14", "7.", ".5", "1..2",
+    // 运算符、分隔符与非法字符
+    "+", "-", "*", "/", "<", "<=", ">", ">=", "=", "==", "!", "!=", "(", ")", "{", "}",
+    ",", ".", ":", ";", "#", "@", "$", "\"", "'", "?", "&", "~",
+    // 空白
+    " ", "\t", "\n", "\r\n",
+    // 注释，包括 "/*/" 与未闭合的多行注释
+    "// c\n", "//", "/* c */", "/**/", "/*/ x */", "/*", "*/",
+    // Latin-1：字母、数字类字符、运算符类字符与不换行空格
+    "é", "ß", "ÿ", "µ", "ª", "²", "¼", "×", "÷", "\xC2\xA0",
+    // CJK、全角字符与其他 Unicode 数字
+    "变量", "中", "。", "（", "１", "٣", "१",
+    // 代理对
+    "😀", "𝑥",
+    // 头文件名
+    "#include <a.h>", "#include \"b.h\"", "  #  include <c>", "#include <unterminated",
+    "x #include <d.h>", "#include\t\"e f.h\"",
+};
+
+template <typename T, int N>
+constexpr int countOf(T (&)[N]) { return N; }
+
+QString describe(const QVector<Token> &tokens, int i)
+{
+    if (i >= tokens.size()) return QString("（无）");
+    const Token &token = tokens[i];
+    return QString("%1 \"%2\" @%3").arg(getTokenTypeString(token.type), token.value).arg(token.offset);
+}
+
+} // namespace
+
+ScannerCheck::ScannerCheck(const QStringList &arguments)
+    : randomCount(-1)
+    , rng(DEFAULT_SEED)
+    , tokenCount(0)
+    , scannerNs(0)
+    , dfaNs(0)
+{
+    for (int i = 0; i < arguments.size(); ++i) {
+        const QString &argument = arguments[i];
+        if (argument == "--random" && i + 1 < arguments.size()) {
+            randomCount = arguments[++i].toInt();
+        } else if (argument == "--seed" && i + 1 < arguments.size()) {
+            rng.seed(arguments[++i].toUInt());
+        } else {
+            paths.append(argument);
+        }
+    }
+    if (randomCount < 0) randomCount = paths.isEmpty() ? DEFAULT_RANDOM : 0;
+}
+
+int ScannerCheck::run()
+{
+    QTextStream out(stdout);
+    int checked = 0;
+    int failures = 0;
+
+    for (const QString &path : paths) {
+        QString text;
+        const QString difference = readSourceText(path, text) ? compare(text) : QString("无法读取文件");
+        ++checked;
+        if (difference.isEmpty()) continue;
+        ++failures;
+        out << path << ": " << difference << "\n";
+    }
+
+    for (int i = 0; i < randomCount; ++i) {
+        const QString source = randomSource();
+        const QString difference = compare(source);
+        ++checked;
+        if (difference.isEmpty()) continue;
+        ++failures;
+        out << QString("随机源代码 #%1: ").arg(i) << difference << "\n" << source << "\n";
+    }
+
+    const QString fixed = checkFixedCases();
+    if (!fixed.isEmpty()) {
+        ++failures;
+        out << fixed << "\n";
+    }
+
+    out << QString("检查了 %1 段源代码，%2 处不一致\n").arg(checked).arg(failures);
+    if (scannerNs > 0 && dfaNs > 0) {
+        out << QString("吞吐量：Scanner %1 万 Token/秒，DfaScanner %2 万 Token/秒\n")
+                   .arg(tokenCount * 1e5 / scannerNs, 0, 'f', 1)
+                   .arg(tokenCount * 1e5 / dfaNs, 0, 'f', 1);
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+QString ScannerCheck::compare(const QString &source)
+{
+    QElapsedTimer timer;
+
+    timer.start();
+    Scanner scanner(source);
+    scanner.setWarningsEnabled(false);
+    const QVector<Token> expected = scanner.scanTokens();
+    scannerNs += timer.nsecsElapsed();
+
+    timer.restart();
+    DfaScanner dfa(source);
+    dfa.setWarningsEnabled(false);
+    const QVector<Token> actual = dfa.scanTokens();
+    dfaNs += timer.nsecsElapsed();
+    tokenCount += expected.size();
+
+    for (int i = 0; i < qMax(expected.size(), actual.size()); ++i) {
+        if (i < expected.size() && i < actual.size() && expected[i].type == actual[i].type
+            && expected[i].value == actual[i].value && expected[i].offset == actual[i].offset) {
+            continue;
+        }
+        return QString("第 %1 个 Token 不同：Scanner %2；DfaScanner %3")
+            .arg(i + 1)
+            .arg(describe(expected, i), describe(actual, i));
+    }
+    return QString();
+}
+
+QString ScannerCheck::checkFixedCases()
+{
+    const struct {
+        const char *name;
+        const char *source;
+    } cases[] = {
+        {"ASCII", "int main() {\n    float x = 3.14;\n    if (x >= 1.) return x / 2; // 注释\n}\n"},
+        {"Latin-1", "int café = 1;\nfloat straße = café * 2.5;\nchar µ = ª;\n"},
+        {"CJK", "int 变量 = １２;\n变量 = 变量 + ٣;\n"},
+        {"未闭合注释", "int x = 1; /* 没有结束"},
+        {"注释起始", "/*/ 仍在注释中 */ int y; /**/ int z;"},
+        {"头文件名", "#include <stdio.h>\n  # include \"a b.h\"\nint include; x #include <no.h>\n"},
+    };
+
+    for (const auto &fixed : cases) {
+        const QString difference = compare(QString::fromUtf8(fixed.source));
+        if (!difference.isEmpty()) return QString("固定用例（%1）：").arg(fixed.name) + difference;
+    }
+    return QString();
+}
+
+QString ScannerCheck::randomSource()
+{
+    QString out;
+    const int count = 1 + rng.bounded(40);
+    for (int i = 0; i < count; ++i) {
+        out += QString::fromUtf8(FRAGMENTS[rng.bounded(countOf(FRAGMENTS))]);
+        // 片段之间多数情况下不加空白，让相邻片段在边界处组合成新的 Token
+        if (rng.bounded(4) == 0) out += ' ';
+    }
+    return out;
+}
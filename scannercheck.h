@@ -0,0 +1,61 @@
+#ifndef SCANNERCHECK_H
+#define SCANNERCHECK_H
+
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QVector>
+#include "token.h"
+
+/**
+ * @class ScannerCheck
+ * @brief 手写的 Scanner 与表驱动的 DfaScanner 的差分检查。
+ *
+ * 对同一段源代码分别运行两个扫描器，要求得到的 Token 序列逐个相同：类型、文本
+ * 与偏移量都一致。输入可以是命令行给出的源文件，也可以是由各类片段随机拼接的
+ * 源代码，片段覆盖 ASCII 运算符与关键字、Latin-1 与 CJK 字符、Unicode 数字、
+ * 代理对、注释（含未闭合的多行注释）以及 #include 头文件名；另外固定检查几段
+ * 典型的源代码。通过 --check-scanners 启动。
+ */
+class ScannerCheck
+{
+public:
+    /**
+     * @brief 构造差分检查。
+     * @param arguments --check-scanners 之后的命令行参数：源文件路径，以及可选的
+     *        --random N（随机源代码个数，未给出源文件时默认 20000）、--seed S（随机种子）。
+     */
+    explicit ScannerCheck(const QStringList &arguments);
+
+    /**
+     * @brief 运行全部检查并输出结果。
+     * @return 进程退出码：全部一致时为 0。
+     */
+    int run();
+
+private:
+    /**
+     * @brief 比较两个扫描器对同一段源代码的结果，并累计两者的扫描耗时。
+     * @return 第一处差异的描述，完全一致时为空。
+     */
+    QString compare(const QString &source);
+
+    /**
+     * @brief 检查固定的几段源代码。
+     * @return 第一处问题的描述，全部通过时为空。
+     */
+    QString checkFixedCases();
+
+    /**
+     * @brief 随机拼接一段源代码。
+     */
+    QString randomSource();
+
+    QStringList paths;      ///< 要检查的源文件。
+    int randomCount;        ///< 随机源代码的个数。
+    QRandomGenerator rng;   ///< 随机源代码生成器。
+    qint64 tokenCount;      ///< 已比较的 Token 总数。
+    qint64 scannerNs;       ///< Scanner 的累计扫描耗时。
+    qint64 dfaNs;           ///< DfaScanner 的累计扫描耗时。
+};
+
+#endif // SCANNERCHECK_H
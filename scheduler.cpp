@@ -0,0 +1,126 @@
+#include "scheduler.h"
+#include "pipeline.h"
+#include <QThread>
+
+CompileScheduler::CompileScheduler(int maxThreads)
+    : focused(nullptr), workers(0)
+{
+    maxWorkers = maxThreads > 0 ? maxThreads : qMax(1, QThread::idealThreadCount() - 1);
+    pool.setMaxThreadCount(maxWorkers);
+}
+
+CompileScheduler::~CompileScheduler()
+{
+    pool.waitForDone();
+}
+
+void CompileScheduler::setFocused(CompilePipeline *pipeline)
+{
+    QMutexLocker locker(&mutex);
+    focused = pipeline;
+    dispatch();
+}
+
+bool CompileScheduler::isFocused(const CompilePipeline *pipeline) const
+{
+    QMutexLocker locker(&mutex);
+    return focused == pipeline;
+}
+
+void CompileScheduler::submit(CompilePipeline *pipeline)
+{
+    QMutexLocker locker(&mutex);
+    if (retired.contains(pipeline)) return;
+    if (!queue.contains(pipeline)) queue.append(pipeline);
+    dispatch();
+}
+
+void CompileScheduler::withdraw(CompilePipeline *pipeline)
+{
+    QMutexLocker locker(&mutex);
+    if (focused == pipeline) focused = nullptr;
+    // 运行中的任务可能在结束前把自己重新排队，因此每次醒来都要再移出一次
+    for (;;) {
+        queue.removeAll(pipeline);
+        if (!running.contains(pipeline)) break;
+        finished.wait(&mutex);
+    }
+    retired.remove(pipeline);
+    dispatch();
+}
+
+void CompileScheduler::retire(CompilePipeline *pipeline)
+{
+    QMutexLocker locker(&mutex);
+    if (focused == pipeline) focused = nullptr;
+    queue.removeAll(pipeline);
+    retired.insert(pipeline);
+    // 正在运行时由 drain() 在任务结束后删除，界面线程不等待
+    if (!running.contains(pipeline)) pipeline->deleteLater();
+    dispatch();
+}
+
+QThreadPool *CompileScheduler::threadPool()
+{
+    return &pool;
+}
+
+bool CompileScheduler::shouldYield(const CompilePipeline *pipeline) const
+{
+    QMutexLocker locker(&mutex);
+    if (focused == nullptr || focused == pipeline) return false;
+    return queue.contains(focused) || running.contains(focused);
+}
+
+void CompileScheduler::drain()
+{
+    QMutexLocker locker(&mutex);
+    for (;;) {
+        CompilePipeline *pipeline = next();
+        if (pipeline == nullptr) {
+            --workers;
+            return;
+        }
+        running.insert(pipeline);
+        dispatch();
+
+        locker.unlock();
+        pipeline->runPending();
+        locker.relock();
+
+        running.remove(pipeline);
+        if (retired.contains(pipeline)) pipeline->deleteLater();
+        finished.wakeAll();
+    }
+}
+
+CompilePipeline *CompileScheduler::next()
+{
+    // 前台有任务可运行时优先取它
+    if (focused != nullptr && !running.contains(focused) && queue.removeOne(focused)) {
+        return focused;
+    }
+    // 前台任务在等待或运行时，后台任务一律让路
+    if (focused != nullptr && (running.contains(focused) || queue.contains(focused))) {
+        return nullptr;
+    }
+    // 后台任务最多占用上限减一个线程，为前台保留一个
+    if (running.size() >= qMax(1, maxWorkers - 1)) return nullptr;
+    for (int i = 0; i < queue.size(); ++i) {
+        CompilePipeline *pipeline = queue[i];
+        if (!running.contains(pipeline)) {
+            queue.removeAt(i);
+            return pipeline;
+        }
+    }
+    return nullptr;
+}
+
+void CompileScheduler::dispatch()
+{
+    // 空闲的工作线程会自己取任务；只有全部在忙时才需要新线程
+    if (workers < maxWorkers && workers <= running.size() && !queue.isEmpty()) {
+        ++workers;
+        pool.start([this]() { drain(); });
+    }
+}
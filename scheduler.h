@@ -0,0 +1,110 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+class CompilePipeline;
+
+/**
+ * @class CompileScheduler
+ * @brief 多个文档的编译流水线共用的后台调度器。
+ *
+ * 所有流水线共享一个有上限的线程池。有任务的流水线在队列中排队，工作线程每次取出
+ * 一个执行，同一条流水线同一时刻只在一个线程上运行，其内存池因此无需加锁。
+ *
+ * 前台文档的并行语法分析也在这个线程池上运行（见 threadPool()），分析线程与工作线程
+ * 合计不超过上限，不会再向全局线程池申请线程。
+ *
+ * 取任务时前台（当前焦点）文档总是优先：它有任务在等待或正在运行时，不再开始新的
+ * 后台任务，正在运行的后台任务也会在下一个检查点让出线程（见 shouldYield()），稍后
+ * 重新排队。后台任务最多占用上限减一个线程，前台文档因此总有空闲线程可用。
+ */
+class CompileScheduler
+{
+public:
+    /**
+     * @brief 构造调度器。
+     * @param maxThreads 线程上限；不大于 0 时取 CPU 核数减一，为界面线程留出一个核。
+     */
+    explicit CompileScheduler(int maxThreads = 0);
+
+    /**
+     * @brief 等待所有工作线程退出。此前所有流水线都应已调用 withdraw()。
+     */
+    ~CompileScheduler();
+
+    /**
+     * @brief 设置前台流水线，可为空。只影响之后的取任务顺序与让出判断。
+     */
+    void setFocused(CompilePipeline *pipeline);
+
+    /**
+     * @brief 判断流水线是否为前台流水线。
+     */
+    bool isFocused(const CompilePipeline *pipeline) const;
+
+    /**
+     * @brief 流水线有新任务时调用，把它放入队列；已在队列中时不重复加入。
+     */
+    void submit(CompilePipeline *pipeline);
+
+    /**
+     * @brief 把流水线移出队列，并等待它正在运行的任务结束。流水线析构前必须调用。
+     */
+    void withdraw(CompilePipeline *pipeline);
+
+    /**
+     * @brief 不等待地退役流水线：移出队列，空闲后交给其所在线程的事件循环删除。
+     *
+     * 流水线没有任务在运行时立即 deleteLater()；否则在任务结束时由工作线程调用。
+     * 退役后的流水线不再被提交。调用前应先取消流水线的任务，使其尽快结束。
+     */
+    void retire(CompilePipeline *pipeline);
+
+    /**
+     * @brief 返回共用的线程池，供任务内部的并行工作使用。
+     *
+     * 线程池没有空闲线程时并行工作在调用线程上依次完成，新的工作线程则排队等待。
+     */
+    QThreadPool *threadPool();
+
+    /**
+     * @brief 判断正在运行的后台任务是否应让出线程。
+     *
+     * 前台流水线有任务在等待或正在运行时返回 true；前台流水线自身总是返回 false。
+     */
+    bool shouldYield(const CompilePipeline *pipeline) const;
+
+private:
+    /**
+     * @brief 工作线程的主循环：不断取任务执行，取不到时退出。
+     */
+    void drain();
+
+    /**
+     * @brief 按优先级取出下一条可运行的流水线，调用时须持有 mutex。
+     * @return 没有可运行的流水线时返回空指针。
+     */
+    CompilePipeline *next();
+
+    /**
+     * @brief 所有工作线程都在忙且队列中还有任务时再启动一个工作线程，调用时须持有 mutex。
+     */
+    void dispatch();
+
+    mutable QMutex mutex;             ///< 保护以下所有成员。
+    QWaitCondition finished;          ///< 有任务结束时唤醒 withdraw()。
+    QList<CompilePipeline *> queue;   ///< 等待运行的流水线，按提交顺序排列。
+    QSet<CompilePipeline *> running;  ///< 正在运行的流水线。
+    QSet<CompilePipeline *> retired;  ///< 已退役、等待删除的流水线。
+    CompilePipeline *focused;         ///< 前台流水线。
+    int workers;                      ///< 当前的工作线程数。
+    int maxWorkers;                   ///< 工作线程上限。
+    QThreadPool pool;                 ///< 共用的线程池。
+};
+
+#endif // SCHEDULER_H
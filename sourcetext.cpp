@@ -0,0 +1,34 @@
+#include "sourcetext.h"
+#include <QFile>
+
+namespace {
+
+// 把 \r\n 与单独的 \r 统一为 \n；编辑器把二者都当作段落分隔
+void normalizeLineBreaks(QString &text) {
+    if (!text.contains(QChar('\r'))) return;
+    text.replace(QStringLiteral("\r\n"), QStringLiteral("\n"));
+    text.replace(QChar('\r'), QChar('\n'));
+}
+
+} // namespace
+
+bool readSourceText(const QString &path, QString &text) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    const qint64 size = file.size();
+    const uchar *data = size > 0 ? file.map(0, size) : nullptr;
+    if (data != nullptr) {
+        const char *bytes = reinterpret_cast<const char *>(data);
+        qint64 begin = 0;
+        if (size >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF) begin = 3;
+        text = QString::fromUtf8(bytes + begin, size - begin);
+        file.unmap(const_cast<uchar *>(data));
+    } else {
+        QByteArray bytes = file.readAll();
+        if (bytes.startsWith("\xEF\xBB\xBF")) bytes.remove(0, 3);
+        text = QString::fromUtf8(bytes);
+    }
+    normalizeLineBreaks(text);
+    return true;
+}
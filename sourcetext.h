@@ -0,0 +1,18 @@
+#ifndef SOURCETEXT_H
+#define SOURCETEXT_H
+
+#include <QString>
+
+/**
+ * @brief 读取 UTF-8 源文件。
+ *
+ * 文件整体映射到内存（QFile::map）后直接从映射区解码，不再经过 readAll() 的中间缓冲；
+ * 无法映射时（如管道或特殊文件）退回到逐块读取。开头的 UTF-8 BOM 会被去掉，
+ * 换行统一为 '\n'，与编辑器中的文本逐字符一致，偏移量因此可以直接对应。
+ * @param path 文件路径。
+ * @param text 读取结果。
+ * @return 文件无法打开时返回 false。
+ */
+bool readSourceText(const QString &path, QString &text);
+
+#endif // SOURCETEXT_H
@@ -0,0 +1,125 @@
+#include "structuralindex.h"
+
+namespace {
+
+bool isOpening(TokenType type) {
+    return type == TokenType::LEFT_PAREN || type == TokenType::LEFT_BRACE;
+}
+
+// 可能作为语句或声明开头的关键字，错误恢复时在此停下
+bool isSyncKeyword(TokenType type) {
+    switch (type) {
+        case TokenType::INT:
+        case TokenType::FLOAT:
+        case TokenType::CHAR:
+        case TokenType::IF:
+        case TokenType::WHILE:
+        case TokenType::FOR:
+        case TokenType::RETURN:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+StructuralIndex::StructuralIndex(const QVector<Token>& tokens, std::pmr::memory_resource* memory)
+    : partner(memory), syncPoint(memory), topLevel(memory) {
+    const int count = tokens.size();
+    partner.assign(count, -1);
+
+    // 第一遍：无分支地收集括号与 ';' 的下标
+    std::pmr::vector<int> structural(count, memory);
+    int structuralCount = 0;
+    for (int i = 0; i < count; ++i) {
+        const TokenType type = tokens[i].type;
+        structural[structuralCount] = i;
+        structuralCount += (type == TokenType::LEFT_PAREN) | (type == TokenType::RIGHT_PAREN)
+                         | (type == TokenType::LEFT_BRACE) | (type == TokenType::RIGHT_BRACE)
+                         | (type == TokenType::SEMICOLON);
+    }
+
+    // 第二遍：只遍历收集到的下标，配对括号，并在深度为 0 处切分顶层声明
+    std::pmr::vector<int> stack(memory);
+    int declBegin = 0;
+    for (int k = 0; k < structuralCount; ++k) {
+        const int i = structural[k];
+        const TokenType type = tokens[i].type;
+
+        const bool followedByElse = i + 1 < count && tokens[i + 1].type == TokenType::ELSE;
+        if (type == TokenType::SEMICOLON) {
+            // 顶层 if 语句体之后紧跟 else 时，else 分支属于同一条语句
+            if (stack.empty() && !followedByElse) {
+                topLevel.push_back({declBegin, i + 1});
+                declBegin = i + 1;
+            }
+            continue;
+        }
+        if (isOpening(type)) {
+            stack.push_back(i);
+            continue;
+        }
+        const TokenType open = type == TokenType::RIGHT_PAREN ? TokenType::LEFT_PAREN
+                                                              : TokenType::LEFT_BRACE;
+        // '}' 遇到未闭合的 '('：这些 '(' 不再可能配对，直接弹出
+        if (type == TokenType::RIGHT_BRACE) {
+            while (!stack.empty() && tokens[stack.back()].type != open) {
+                stack.pop_back();
+                balanced = false;
+            }
+        }
+        if (stack.empty() || tokens[stack.back()].type != open) {
+            balanced = false;
+            continue;
+        }
+        const int openIndex = stack.back();
+        stack.pop_back();
+        partner[openIndex] = i;
+        partner[i] = openIndex;
+
+        if (type == TokenType::RIGHT_BRACE && stack.empty() && !followedByElse) {
+            topLevel.push_back({declBegin, i + 1});
+            declBegin = i + 1;
+        }
+    }
+
+    if (!stack.empty()) balanced = false;
+
+    const int end = count > 0 && tokens[count - 1].type == TokenType::EOF_TOKEN ? count - 1 : count;
+    if (declBegin < end) {
+        topLevel.push_back({declBegin, end});
+    }
+
+    // 从后向前计算每个位置之后的第一个同步点，括号组整体越过
+    syncPoint.resize(end + 1);
+    syncPoint[end] = end;
+    for (int i = end - 1; i >= 0; --i) {
+        const TokenType type = tokens[i].type;
+        if ((i > 0 && tokens[i - 1].type == TokenType::SEMICOLON) || isSyncKeyword(type)) {
+            syncPoint[i] = i;
+        } else if (isOpening(type) && partner[i] > i) {
+            syncPoint[i] = syncPoint[partner[i] + 1];
+        } else {
+            syncPoint[i] = syncPoint[i + 1];
+        }
+    }
+}
+
+int StructuralIndex::matching(int index) const {
+    if (index < 0 || index >= static_cast<int>(partner.size())) return -1;
+    return partner[index];
+}
+
+const std::pmr::vector<DeclarationRange>& StructuralIndex::declarations() const {
+    return topLevel;
+}
+
+bool StructuralIndex::isBalanced() const {
+    return balanced;
+}
+
+int StructuralIndex::nextSyncPoint(int index) const {
+    if (index < 0 || index >= static_cast<int>(syncPoint.size())) return index;
+    return syncPoint[index];
+}
@@ -0,0 +1,77 @@
+#ifndef STRUCTURALINDEX_H
+#define STRUCTURALINDEX_H
+
+#include <QVector>
+#include <memory_resource>
+#include "token.h"
+
+/**
+ * @struct DeclarationRange
+ * @brief 一个顶层声明在 Token 序列中的范围，左闭右开 [begin, end)。
+ */
+struct DeclarationRange {
+    int begin; ///< 第一个 Token 的下标。
+    int end;   ///< 最后一个 Token 之后的下标。
+};
+
+/**
+ * @class StructuralIndex
+ * @brief Token 序列的结构索引：括号配对表与顶层声明边界。
+ *
+ * 借鉴 simdjson 的结构索引思路分两遍构建：第一遍无分支地把所有括号与 ';' Token 的
+ * 下标压缩到一个紧凑数组中；第二遍只遍历这个数组，用栈完成括号配对，并根据栈深度
+ * 在顶层的 ';' 与 '}' 处切分顶层声明，其余 Token 不再访问。
+ * 构建完成后，语法分析器及其他工具可以 O(1) 地跳过整个括号组或函数体。
+ */
+class StructuralIndex {
+public:
+    /**
+     * @brief 默认构造函数，构造一个空索引。
+     */
+    StructuralIndex() = default;
+
+    /**
+     * @brief 扫描 Token 序列并建立索引。
+     * @param tokens 以 EOF_TOKEN 结尾的 Token 序列。
+     * @param memory 索引数组使用的内存资源，通常为编译会话的内存池。
+     */
+    explicit StructuralIndex(const QVector<Token>& tokens,
+                             std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * @brief 查询括号的配对位置。
+     * @param index 某个 '(' ')' '{' '}' Token 的下标。
+     * @return 与之配对的 Token 下标；不是括号或未能配对时返回 -1。
+     */
+    int matching(int index) const;
+
+    /**
+     * @brief 返回所有顶层声明（或顶层语句）的范围，按源码顺序排列。
+     *
+     * 顶层的 ';' 或闭合顶层 '{' 的 '}' 结束一个声明；二者之后紧跟 else 时不切分。
+     */
+    const std::pmr::vector<DeclarationRange>& declarations() const;
+
+    /**
+     * @brief 判断所有括号是否都已正确配对。
+     */
+    bool isBalanced() const;
+
+    /**
+     * @brief 查询错误恢复的同步点。
+     *
+     * 同步点是紧跟在 ';' 之后、或以 int/float/char/if/while/for/return 开头的位置；
+     * 途中的完整括号组被整体越过。结果预先计算，查询为 O(1)。
+     * @param index 开始查找的 Token 下标。
+     * @return 不小于 index 的第一个同步点；之后没有同步点时返回 EOF_TOKEN 的下标。
+     */
+    int nextSyncPoint(int index) const;
+
+private:
+    std::pmr::vector<int> partner;                ///< 每个 Token 的配对下标，非括号为 -1。
+    std::pmr::vector<int> syncPoint;              ///< 每个下标之后的第一个同步点。
+    std::pmr::vector<DeclarationRange> topLevel;  ///< 顶层声明范围。
+    bool balanced = true;                         ///< 括号是否全部配对。
+};
+
+#endif // STRUCTURALINDEX_H
@@ -0,0 +1,84 @@
+#include "symboltable.h"
+#include <QHash>
+
+namespace {
+
+constexpr int INITIAL_SLOTS = 64; // 必须为 2 的幂
+
+} // namespace
+
+SymbolTable::SymbolTable(std::pmr::memory_resource* memory)
+    : buckets(INITIAL_SLOTS, -1, memory), entries(memory), symbols(memory), scopes(memory) {}
+
+int SymbolTable::findSlot(const QString& name, size_t hash) const {
+    const size_t mask = buckets.size() - 1;
+    size_t slot = hash & mask;
+    // 线性探测，装载因子不超过 1/2，探测长度期望为常数
+    while (buckets[slot] >= 0) {
+        const Entry& entry = entries[buckets[slot]];
+        if (entry.hash == hash && entry.name == name) break;
+        slot = (slot + 1) & mask;
+    }
+    return static_cast<int>(slot);
+}
+
+void SymbolTable::grow() {
+    std::pmr::vector<int> larger(buckets.size() * 2, -1, buckets.get_allocator());
+    const size_t mask = larger.size() - 1;
+    for (int id = 0; id < static_cast<int>(entries.size()); ++id) {
+        size_t slot = entries[id].hash & mask;
+        while (larger[slot] >= 0) slot = (slot + 1) & mask;
+        larger[slot] = id;
+    }
+    buckets.swap(larger);
+}
+
+int SymbolTable::intern(const QString& name) {
+    const size_t hash = qHash(name);
+    int slot = findSlot(name, hash);
+    if (buckets[slot] >= 0) return buckets[slot];
+
+    if ((entries.size() + 1) * 2 > buckets.size()) {
+        grow();
+        slot = findSlot(name, hash);
+    }
+    const int id = static_cast<int>(entries.size());
+    entries.push_back({name, hash, -1});
+    buckets[slot] = id;
+    return id;
+}
+
+const Symbol* SymbolTable::lookup(const QString& name) const {
+    const int id = buckets[findSlot(name, qHash(name))];
+    if (id < 0 || entries[id].binding < 0) return nullptr;
+    return &symbols[entries[id].binding];
+}
+
+bool SymbolTable::declare(const QString& name, TokenType type, bool isFunction, int tokenIndex) {
+    const int id = intern(name);
+    const int previous = entries[id].binding;
+    if (previous >= 0 && symbols[previous].depth == depth()) return false;
+
+    entries[id].binding = static_cast<int>(symbols.size());
+    symbols.push_back({type, isFunction, tokenIndex, depth(), id, previous});
+    return true;
+}
+
+void SymbolTable::enterScope() {
+    scopes.push_back(static_cast<int>(symbols.size()));
+}
+
+void SymbolTable::exitScope() {
+    if (scopes.empty()) return;
+    const int mark = scopes.back();
+    scopes.pop_back();
+    while (static_cast<int>(symbols.size()) > mark) {
+        const Symbol& symbol = symbols.back();
+        entries[symbol.id].binding = symbol.shadowed;
+        symbols.pop_back();
+    }
+}
+
+int SymbolTable::depth() const {
+    return static_cast<int>(scopes.size());
+}
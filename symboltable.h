@@ -0,0 +1,101 @@
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <QString>
+#include <memory_resource>
+#include "token.h"
+
+/**
+ * @struct Symbol
+ * @brief 符号表中的一条声明。
+ */
+struct Symbol {
+    TokenType type;   ///< 声明的类型：INT、FLOAT 或 CHAR。
+    bool isFunction;  ///< 是否为函数。
+    int tokenIndex;   ///< 声明处标识符 Token 的下标。
+    int depth;        ///< 所在作用域的嵌套深度，全局为 0。
+    int id;           ///< 标识符的驻留编号。
+    int shadowed;     ///< 被本声明遮蔽的外层声明在符号栈中的下标，-1 表示无。
+};
+
+/**
+ * @class SymbolTable
+ * @brief 支持嵌套作用域的符号表。
+ *
+ * 标识符先驻留（intern）到一张开放寻址的扁平哈希表中，每个标识符得到一个编号，
+ * 编号对应的表项直接保存该名字当前可见的声明。所有声明按出现顺序压入符号栈，
+ * 每条声明记下被它遮蔽的外层声明，符号栈因此同时充当作用域的撤销日志：
+ * 进入作用域只记录栈高，退出作用域时弹出本层声明并恢复被遮蔽的声明。
+ * 查找为 O(1)，进入与退出作用域的均摊代价为 O(1)，总代价与声明数成正比。
+ */
+class SymbolTable {
+public:
+    /**
+     * @brief 构造空符号表，当前处于全局作用域。
+     * @param memory 哈希表与符号栈使用的内存资源。
+     */
+    explicit SymbolTable(std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * @brief 驻留标识符，返回其编号；同名标识符总是得到同一编号。
+     */
+    int intern(const QString& name);
+
+    /**
+     * @brief 查找名字当前可见的声明。
+     * @return 声明；名字未声明时返回 nullptr。
+     */
+    const Symbol* lookup(const QString& name) const;
+
+    /**
+     * @brief 在当前作用域中声明名字。
+     * @param name 标识符。
+     * @param type 声明的类型。
+     * @param isFunction 是否为函数。
+     * @param tokenIndex 声明处标识符 Token 的下标。
+     * @return 同一作用域中已有同名声明时不做修改并返回 false。
+     */
+    bool declare(const QString& name, TokenType type, bool isFunction, int tokenIndex);
+
+    /**
+     * @brief 进入一层新的作用域。
+     */
+    void enterScope();
+
+    /**
+     * @brief 退出当前作用域，撤销本层的所有声明；已处于全局作用域时不做任何事。
+     */
+    void exitScope();
+
+    /**
+     * @brief 返回当前作用域的嵌套深度，全局为 0。
+     */
+    int depth() const;
+
+private:
+    /**
+     * @brief 驻留的标识符。
+     */
+    struct Entry {
+        QString name;  ///< 标识符文本。
+        size_t hash;   ///< 文本的哈希值，扩容时无需重新计算。
+        int binding;   ///< 当前可见声明在符号栈中的下标，-1 表示无。
+    };
+
+    /**
+     * @brief 查找名字所在的槽位：命中时槽位中为其编号，否则为应插入的空槽位。
+     */
+    int findSlot(const QString& name, size_t hash) const;
+
+    /**
+     * @brief 把槽位数翻倍并重新放置所有编号。
+     */
+    void grow();
+
+    std::pmr::vector<int> buckets;    ///< 开放寻址表，保存标识符编号，-1 为空槽位。
+    std::pmr::vector<Entry> entries;  ///< 按编号排列的驻留标识符。
+    std::pmr::vector<Symbol> symbols; ///< 符号栈，兼作作用域撤销日志。
+    std::pmr::vector<int> scopes;     ///< 每层作用域开始时的符号栈高度。
+};
+
+#endif // SYMBOLTABLE_H
@@ -1,8 +1,10 @@
 #include "token.h"
+#include "lineindex.h"
 #include <QDebug>
+#include <QMap>
 
-Token::Token(TokenType type, const QString& value, int line)
-    : type(type), value(value), line(line) {}
+Token::Token(TokenType type, const QString& value, int offset)
+    : type(type), value(value), offset(offset) {}
 
 QString getTokenTypeString(TokenType type) {
     switch (type) {
@@ -29,10 +31,12 @@ QString getTokenTypeString(TokenType type) {
         case TokenType::COMMA:            return "COMMA";
         case TokenType::DOT:              return "DOT";
         case TokenType::COLON:            return "COLON";
+        case TokenType::HASH:             return "HASH";
 
         // 字面量
         case TokenType::NUMBER:           return "NUMBER";
         case TokenType::IDENTIFIER:       return "IDENTIFIER";
+        case TokenType::HEADER_NAME:      return "HEADER_NAME";
 
         // 关键字（C99）
         case TokenType::AUTO:             return "AUTO";
@@ -83,18 +87,140 @@ QString getTokenTypeString(TokenType type) {
     }
 }
 
-void printToken(const Token &token)
+QString tokenSpelling(TokenType type) {
+    switch (type) {
+        // 运算符
+        case TokenType::PLUS:             return QStringLiteral("+");
+        case TokenType::MINUS:            return QStringLiteral("-");
+        case TokenType::MULTIPLY:         return QStringLiteral("*");
+        case TokenType::DIVIDE:           return QStringLiteral("/");
+        case TokenType::EQUAL:            return QStringLiteral("==");
+        case TokenType::NOT_EQUAL:        return QStringLiteral("!=");
+        case TokenType::LESS:             return QStringLiteral("<");
+        case TokenType::GREATER:          return QStringLiteral(">");
+        case TokenType::LESS_EQUAL:       return QStringLiteral("<=");
+        case TokenType::GREATER_EQUAL:    return QStringLiteral(">=");
+        case TokenType::ASSIGNMENT:       return QStringLiteral("=");
+        case TokenType::BANG:             return QStringLiteral("!");
+
+        // 分隔符
+        case TokenType::LEFT_PAREN:       return QStringLiteral("(");
+        case TokenType::RIGHT_PAREN:      return QStringLiteral(")");
+        case TokenType::SEMICOLON:        return QStringLiteral(";");
+        case TokenType::LEFT_BRACE:       return QStringLiteral("{");
+        case TokenType::RIGHT_BRACE:      return QStringLiteral("}");
+        case TokenType::COMMA:            return QStringLiteral(",");
+        case TokenType::DOT:              return QStringLiteral(".");
+        case TokenType::COLON:            return QStringLiteral(":");
+        case TokenType::HASH:             return QStringLiteral("#");
+
+        // 关键字（C99）
+        case TokenType::AUTO:             return QStringLiteral("auto");
+        case TokenType::BREAK:            return QStringLiteral("break");
+        case TokenType::CASE:             return QStringLiteral("case");
+        case TokenType::CHAR:             return QStringLiteral("char");
+        case TokenType::CONST:            return QStringLiteral("const");
+        case TokenType::CONTINUE:         return QStringLiteral("continue");
+        case TokenType::DEFAULT:          return QStringLiteral("default");
+        case TokenType::DO:               return QStringLiteral("do");
+        case TokenType::DOUBLE:           return QStringLiteral("double");
+        case TokenType::ELSE:             return QStringLiteral("else");
+        case TokenType::ENUM:             return QStringLiteral("enum");
+        case TokenType::EXTERN:           return QStringLiteral("extern");
+        case TokenType::FLOAT:            return QStringLiteral("float");
+        case TokenType::FOR:              return QStringLiteral("for");
+        case TokenType::GOTO:             return QStringLiteral("goto");
+        case TokenType::IF:               return QStringLiteral("if");
+        case TokenType::INLINE:           return QStringLiteral("inline");
+        case TokenType::INT:              return QStringLiteral("int");
+        case TokenType::LONG:             return QStringLiteral("long");
+        case TokenType::REGISTER:         return QStringLiteral("register");
+        case TokenType::RESTRICT:         return QStringLiteral("restrict");
+        case TokenType::RETURN:           return QStringLiteral("return");
+        case TokenType::SHORT:            return QStringLiteral("short");
+        case TokenType::SIGNED:           return QStringLiteral("signed");
+        case TokenType::SIZEOF:           return QStringLiteral("sizeof");
+        case TokenType::STATIC:           return QStringLiteral("static");
+        case TokenType::STRUCT:           return QStringLiteral("struct");
+        case TokenType::SWITCH:           return QStringLiteral("switch");
+        case TokenType::TYPEDEF:          return QStringLiteral("typedef");
+        case TokenType::UNION:            return QStringLiteral("union");
+        case TokenType::UNSIGNED:         return QStringLiteral("unsigned");
+        case TokenType::VOID:             return QStringLiteral("void");
+        case TokenType::VOLATILE:         return QStringLiteral("volatile");
+        case TokenType::WHILE:            return QStringLiteral("while");
+        case TokenType::_BOOL:            return QStringLiteral("_Bool");
+        case TokenType::_COMPLEX:         return QStringLiteral("_Complex");
+        case TokenType::_IMAGINARY:       return QStringLiteral("_Imaginary");
+
+        default:                          return QString();
+    }
+}
+
+TokenType lookupKeyword(const QString& text) {
+    static const QMap<QString, TokenType> keywords = {
+        {"auto", TokenType::AUTO},
+        {"break", TokenType::BREAK},
+        {"case", TokenType::CASE},
+        {"char", TokenType::CHAR},
+        {"const", TokenType::CONST},
+        {"continue", TokenType::CONTINUE},
+        {"default", TokenType::DEFAULT},
+        {"do", TokenType::DO},
+        {"double", TokenType::DOUBLE},
+        {"else", TokenType::ELSE},
+        {"enum", TokenType::ENUM},
+        {"extern", TokenType::EXTERN},
+        {"float", TokenType::FLOAT},
+        {"for", TokenType::FOR},
+        {"goto", TokenType::GOTO},
+        {"if", TokenType::IF},
+        {"inline", TokenType::INLINE},
+        {"int", TokenType::INT},
+        {"long", TokenType::LONG},
+        {"register", TokenType::REGISTER},
+        {"restrict", TokenType::RESTRICT},
+        {"return", TokenType::RETURN},
+        {"short", TokenType::SHORT},
+        {"signed", TokenType::SIGNED},
+        {"sizeof", TokenType::SIZEOF},
+        {"static", TokenType::STATIC},
+        {"struct", TokenType::STRUCT},
+        {"switch", TokenType::SWITCH},
+        {"typedef", TokenType::TYPEDEF},
+        {"union", TokenType::UNION},
+        {"unsigned", TokenType::UNSIGNED},
+        {"void", TokenType::VOID},
+        {"volatile", TokenType::VOLATILE},
+        {"while", TokenType::WHILE},
+        {"_Bool", TokenType::_BOOL},
+        {"_Complex", TokenType::_COMPLEX},
+        {"_Imaginary", TokenType::_IMAGINARY}
+    };
+
+    return keywords.value(text, TokenType::IDENTIFIER);
+}
+
+void printToken(const Token &token, const LineIndex *lines)
 {
     QString typeString = getTokenTypeString(token.type);
     QString valueString = token.value.isEmpty() ? "N/A" : token.value;
-    qDebug() << "Token Type:" << typeString
-             << ", Value:" << valueString
-             << ", Line:" << token.line;
+    if (lines) {
+        SourceLocation loc = lines->locate(token.offset);
+        qDebug() << "Token Type:" << typeString
+                 << ", Value:" << valueString
+                 << ", Line:" << loc.line
+                 << ", Column:" << loc.column;
+    } else {
+        qDebug() << "Token Type:" << typeString
+                 << ", Value:" << valueString
+                 << ", Offset:" << token.offset;
+    }
 }
 
-void printTokens(const QVector<Token> &tokens)
+void printTokens(const QVector<Token> &tokens, const LineIndex *lines)
 {
     for (const Token &token : tokens) {
-        printToken(token);
+        printToken(token, lines);
     }
 }
@@ -4,6 +4,8 @@
 #include <QString>
 #include <QVector>
 
+class LineIndex;
+
 /**
  * @enum TokenType
  * @brief 枚举定义了所有可能的Token类型，包括运算符、分隔符、字面量和关键字。
@@ -21,9 +23,11 @@ enum class TokenType {
     // 分隔符
     LEFT_PAREN, RIGHT_PAREN, SEMICOLON, LEFT_BRACE, RIGHT_BRACE,
     COMMA, DOT, COLON,
+    HASH,           ///< 表示 # 预处理指令开头
 
     // 字面量
     NUMBER, IDENTIFIER,
+    HEADER_NAME,    ///< 表示 #include 后的 "file.h" 或 <file.h>，含两侧定界符
     
 
     // 关键字（完整C99标准）
@@ -41,12 +45,14 @@ enum class TokenType {
 };
 /**
  * @struct Token
- * @brief 表示源代码中的一个Token，包含其类型、值以及所在行号。
+ * @brief 表示源代码中的一个Token，包含其类型、值以及在源码中的偏移量。
+ *
+ * 行列号不再在扫描时逐字符统计，需要时通过 LineIndex 由 offset 换算得到。
  */
 struct Token {
     TokenType type; ///< Token的类型。
     QString value;  ///< Token的字符串值，对于标识符或数字字面量等有意义。
-    int line;       ///< Token在源文件中出现的行号。
+    int offset;     ///< Token首字符在源文件中的偏移量（UTF-16 码元下标）。
 
     /**
      * @brief 默认构造函数。
@@ -57,9 +63,9 @@ struct Token {
      * @brief 参数化构造函数，用于初始化Token对象。
      * @param type Token的类型。
      * @param value Token的字符串值。
-     * @param line Token在源文件中的行号。
+     * @param offset Token在源文件中的偏移量。
      */
-    Token(TokenType type, const QString& value, int line);
+    Token(TokenType type, const QString& value, int offset);
 };
 
 /**
@@ -70,14 +76,33 @@ struct Token {
 QString getTokenTypeString(TokenType type);
 
 /**
- * @brief 打印Token的详细信息，包括类型、值和行号。
+ * @brief 返回固定拼写的 Token（运算符、分隔符、关键字）的文本。
+ *
+ * 返回的字符串引用静态数据，构造和复制都不分配内存；扫描器用它代替从源码中截取子串，
+ * 只有数字和标识符才需要为文本分配内存。
+ * @param type 需要查询的TokenType。
+ * @return 对应的拼写；数字、标识符等没有固定拼写的类型返回空字符串。
+ */
+QString tokenSpelling(TokenType type);
+
+/**
+ * @brief 查询标识符文本对应的关键字类型。
+ * @param text 标识符文本。
+ * @return 若 text 为 C99 关键字则返回对应的 TokenType，否则返回 TokenType::IDENTIFIER。
+ */
+TokenType lookupKeyword(const QString& text);
+
+/**
+ * @brief 打印Token的详细信息，包括类型、值和位置。
  * @param token 需要打印的Token对象。
+ * @param lines 源代码的行首索引；为空时打印偏移量而不是行列号。
  */
-void printToken(const Token& token);
+void printToken(const Token& token, const LineIndex* lines = nullptr);
 
 /**
- * @brief 打印Token列表的详细信息，包括每个Token的类型、值和行号。
+ * @brief 打印Token列表的详细信息，包括每个Token的类型、值和位置。
  * @param tokens 需要打印的Token列表。
+ * @param lines 源代码的行首索引；为空时打印偏移量而不是行列号。
  */
-void printTokens(const QVector<Token>& tokens);
+void printTokens(const QVector<Token>& tokens, const LineIndex* lines = nullptr);
 #endif // TOKEN_H
\ No newline at end of file
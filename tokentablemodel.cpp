@@ -0,0 +1,78 @@
+#include "tokentablemodel.h"
+
+TokenTableModel::TokenTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int TokenTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : tokens.size();
+}
+
+int TokenTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : 4;
+}
+
+QVariant TokenTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= tokens.size()) return QVariant();
+    if (role == Qt::TextAlignmentRole) return int(Qt::AlignCenter);
+    if (role != Qt::DisplayRole) return QVariant();
+
+    const Token &token = tokens[index.row()];
+    switch (index.column()) {
+        case 0:
+            return static_cast<int>(token.type);
+        case 1:
+            return getTokenTypeString(token.type);
+        case 2:
+            return token.value;
+        case 3: {
+            const SourceLocation loc = lines.locate(token.offset);
+            return QString("%1:%2").arg(loc.line).arg(loc.column);
+        }
+        default:
+            return QVariant();
+    }
+}
+
+QVariant TokenTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) return QVariant();
+    if (orientation == Qt::Vertical) return section + 1;
+    static const char *const headers[] = {"Type (Int)", "Type (Name)", "Value", "Line:Col"};
+    return section >= 0 && section < 4 ? QString(headers[section]) : QVariant();
+}
+
+void TokenTableModel::reset(const LineIndex &lines)
+{
+    beginResetModel();
+    tokens.clear();
+    this->lines = lines;
+    endResetModel();
+}
+
+void TokenTableModel::appendTokens(int firstRow, const QVector<Token> &chunk)
+{
+    if (firstRow != tokens.size() || chunk.isEmpty()) return;
+    beginInsertRows(QModelIndex(), firstRow, firstRow + chunk.size() - 1);
+    tokens.append(chunk);
+    endInsertRows();
+}
+
+void TokenTableModel::setScan(const ScanResult &scan)
+{
+    if (scan.tokens.size() == tokens.size()) {
+        // 内容相同，换成共享的完整结果以释放逐块累积的副本
+        tokens = scan.tokens;
+        lines = scan.lines;
+    } else {
+        beginResetModel();
+        tokens = scan.tokens;
+        lines = scan.lines;
+        endResetModel();
+    }
+    emit scanCompleted();
+}
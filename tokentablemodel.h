@@ -0,0 +1,58 @@
+#ifndef TOKENTABLEMODEL_H
+#define TOKENTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include "pipeline.h"
+
+/**
+ * @class TokenTableModel
+ * @brief 词法分析结果表的数据模型。
+ *
+ * 模型只保存 Token 序列与行首索引，单元格文本与行列号都在视图请求时才生成，
+ * 视图只会请求可见范围内的行，因此即使有上百万个 Token，填表的代价也与可见行数成正比。
+ * 扫描结果本身是隐式共享的，setScan() 不复制 Token。
+ */
+class TokenTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit TokenTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief 清空模型，开始接收新一次扫描的结果。
+     * @param lines 新源代码的行首索引。
+     */
+    void reset(const LineIndex &lines);
+
+    /**
+     * @brief 追加扫描阶段发布的一块 Token。
+     * @param firstRow 本块第一个 Token 的下标，与已有行数不衔接时忽略本块。
+     */
+    void appendTokens(int firstRow, const QVector<Token> &chunk);
+
+    /**
+     * @brief 换用完整的扫描结果。
+     *
+     * 已逐块收到全部 Token 时只替换内部存储，视图无需刷新；否则重置模型。
+     */
+    void setScan(const ScanResult &scan);
+
+signals:
+    /**
+     * @brief setScan() 换上完整的扫描结果后发出，此时表中已是本次扫描的全部 Token。
+     */
+    void scanCompleted();
+
+private:
+    QVector<Token> tokens; ///< 表中的 Token。
+    LineIndex lines;       ///< 用于换算行列号的行首索引。
+};
+
+#endif // TOKENTABLEMODEL_H
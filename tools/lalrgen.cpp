@@ -0,0 +1,474 @@
+// LALR(1) 分析表生成器。
+//
+// 读取 c_subset.grammar 形式的声明式文法，先构造规范 LR(1) 项目集族，再合并同心项目集
+// 得到 LALR(1) 状态，最后把动作表、转移表与产生式表输出为 constexpr 数组的头文件，
+// 供 LalrParser 在编译期直接使用。只依赖标准库，可以在没有 Qt 的主机上构建：
+//
+//     g++ -std=c++17 -O2 -o lalrgen tools/lalrgen.cpp
+//     ./lalrgen tools/c_subset.grammar lalrtables.h
+//
+// 移进/归约冲突按移进解决，数量必须与文法中 %expect 声明的一致；出现归约/归约冲突
+// 或冲突数量不符时不输出任何文件，返回非零退出码。
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Production {
+    int lhs;
+    std::vector<int> rhs;
+    std::string action; // 为空表示默认动作：把第一个符号的语义值传给左部
+};
+
+// LR(1) 项目：产生式、圆点位置与一个向前看终结符
+struct Item {
+    int rule;
+    int dot;
+    int lookahead;
+    bool operator<(const Item& other) const {
+        if (rule != other.rule) return rule < other.rule;
+        if (dot != other.dot) return dot < other.dot;
+        return lookahead < other.lookahead;
+    }
+    bool operator==(const Item& other) const {
+        return rule == other.rule && dot == other.dot && lookahead == other.lookahead;
+    }
+};
+
+using ItemSet = std::vector<Item>; // 有序、无重复
+using TerminalSet = std::uint64_t; // 第 i 位表示第 i 个终结符
+
+class Grammar {
+public:
+    std::vector<std::string> terminals;    // 终结符，最后一个为 EOF_TOKEN
+    std::vector<std::string> nonterminals; // 非终结符，按首次作为左部出现的顺序
+    std::vector<std::string> actions;      // 语义动作名，按首次出现的顺序
+    std::vector<Production> rules;         // 第 0 条为增广产生式 $accept -> start
+    int expected = 0;                      // %expect 声明的移进/归约冲突数
+
+    bool load(const std::string& path);
+
+    int terminalCount() const { return static_cast<int>(terminals.size()); }
+    bool isTerminal(int symbol) const { return symbol < terminalCount(); }
+    int eof() const { return terminalCount() - 1; }
+    std::string symbolName(int symbol) const {
+        if (symbol == acceptSymbol) return "$accept";
+        return isTerminal(symbol) ? terminals[symbol] : nonterminals[symbol - terminalCount()];
+    }
+
+    int acceptSymbol = -1;
+
+private:
+    bool fail(const std::string& message) {
+        std::cerr << "lalrgen: " << message << "\n";
+        return false;
+    }
+};
+
+bool Grammar::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return fail("无法打开 " + path);
+
+    // 指令逐行处理，其余内容连成一串单词交给产生式解析
+    std::vector<std::string> words;
+    std::string start;
+    std::string line;
+    while (std::getline(in, line)) {
+        const std::size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        std::istringstream fields(line);
+        std::string word;
+        if (!(fields >> word)) continue;
+        if (word == "%token") {
+            while (fields >> word) terminals.push_back(word);
+        } else if (word == "%expect") {
+            fields >> expected;
+        } else if (word == "%start") {
+            fields >> start;
+        } else {
+            do {
+                words.push_back(word);
+            } while (fields >> word);
+        }
+    }
+    terminals.push_back("EOF_TOKEN");
+    if (terminals.size() > 64) return fail("终结符超过 64 个");
+
+    // 先收集全部左部，确定非终结符编号
+    for (std::size_t i = 0; i + 1 < words.size(); ++i) {
+        if (words[i + 1] != ":") continue;
+        bool known = false;
+        for (const std::string& name : nonterminals) known = known || name == words[i];
+        if (!known) nonterminals.push_back(words[i]);
+    }
+    if (nonterminals.empty()) return fail("文法中没有产生式");
+    if (start.empty()) start = nonterminals.front();
+
+    auto lookup = [this](const std::string& name) {
+        for (int i = 0; i < terminalCount(); ++i) {
+            if (terminals[i] == name) return i;
+        }
+        for (std::size_t i = 0; i < nonterminals.size(); ++i) {
+            if (nonterminals[i] == name) return terminalCount() + static_cast<int>(i);
+        }
+        return -1;
+    };
+
+    acceptSymbol = terminalCount() + static_cast<int>(nonterminals.size());
+    const int startSymbol = lookup(start);
+    if (startSymbol < terminalCount()) return fail("未知的开始符号 " + start);
+    rules.push_back({acceptSymbol, {startSymbol}, ""});
+
+    std::size_t i = 0;
+    while (i < words.size()) {
+        if (i + 1 >= words.size() || words[i + 1] != ":") return fail("产生式格式错误：" + words[i]);
+        const int lhs = lookup(words[i]);
+        i += 2;
+        Production production{lhs, {}, ""};
+        for (;;) {
+            if (i >= words.size()) return fail("产生式缺少 ';'");
+            const std::string& word = words[i++];
+            if (word == "|" || word == ";") {
+                rules.push_back(production);
+                production = Production{lhs, {}, ""};
+                if (word == ";") break;
+            } else if (word == "%empty") {
+                continue;
+            } else if (word[0] == '@') {
+                production.action = word.substr(1);
+                bool known = false;
+                for (const std::string& name : actions) known = known || name == production.action;
+                if (!known) actions.push_back(production.action);
+            } else {
+                const int symbol = lookup(word);
+                if (symbol < 0) return fail("未声明的符号 " + word);
+                production.rhs.push_back(symbol);
+            }
+        }
+    }
+    return true;
+}
+
+class Generator {
+public:
+    explicit Generator(const Grammar& grammar) : g(grammar) {}
+
+    bool build();
+    void write(std::ostream& out, const std::string& grammarPath) const;
+
+private:
+    void computeFirst();
+    TerminalSet firstOf(const std::vector<int>& symbols, std::size_t from, int lookahead) const;
+    ItemSet closure(ItemSet items) const;
+    ItemSet advance(const ItemSet& items, int symbol) const;
+    void buildCanonical();
+    bool buildTables();
+
+    const Grammar& g;
+    int symbolCount = 0;
+    std::vector<TerminalSet> first; // 每个非终结符的 FIRST 集
+    std::vector<bool> nullable;     // 每个非终结符能否推出空串
+
+    std::vector<ItemSet> canonical;              // 规范 LR(1) 项目集
+    std::vector<std::map<int, int>> canonicalGo; // 规范项目集之间的转移
+
+    int stateCount = 0;
+    std::vector<int> merged;                                // 规范项目集 -> LALR 状态
+    std::vector<std::map<std::pair<int, int>, TerminalSet>> kernel; // LALR 状态的项目与合并后的向前看集
+    std::vector<std::vector<int>> action;                  // 编码同 lalrtables.h
+    std::vector<std::vector<int>> go;                      // 非终结符转移，-1 表示无
+    int shiftReduce = 0;
+    int reduceReduce = 0;
+};
+
+void Generator::computeFirst() {
+    const int nonterminalCount = static_cast<int>(g.nonterminals.size()) + 1; // 含 $accept
+    first.assign(nonterminalCount, 0);
+    nullable.assign(nonterminalCount, false);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const Production& rule : g.rules) {
+            const int lhs = rule.lhs - g.terminalCount();
+            TerminalSet set = first[lhs];
+            bool allNullable = true;
+            for (int symbol : rule.rhs) {
+                if (g.isTerminal(symbol)) {
+                    set |= TerminalSet(1) << symbol;
+                    allNullable = false;
+                    break;
+                }
+                set |= first[symbol - g.terminalCount()];
+                if (!nullable[symbol - g.terminalCount()]) {
+                    allNullable = false;
+                    break;
+                }
+            }
+            if (set != first[lhs] || (allNullable && !nullable[lhs])) {
+                first[lhs] = set;
+                nullable[lhs] = nullable[lhs] || allNullable;
+                changed = true;
+            }
+        }
+    }
+}
+
+TerminalSet Generator::firstOf(const std::vector<int>& symbols, std::size_t from, int lookahead) const {
+    TerminalSet set = 0;
+    for (std::size_t i = from; i < symbols.size(); ++i) {
+        const int symbol = symbols[i];
+        if (g.isTerminal(symbol)) return set | (TerminalSet(1) << symbol);
+        set |= first[symbol - g.terminalCount()];
+        if (!nullable[symbol - g.terminalCount()]) return set;
+    }
+    return set | (TerminalSet(1) << lookahead);
+}
+
+ItemSet Generator::closure(ItemSet items) const {
+    std::set<Item> seen(items.begin(), items.end());
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        const Item item = items[i];
+        const Production& rule = g.rules[item.rule];
+        if (item.dot >= static_cast<int>(rule.rhs.size())) continue;
+        const int next = rule.rhs[item.dot];
+        if (g.isTerminal(next)) continue;
+        const TerminalSet lookaheads = firstOf(rule.rhs, item.dot + 1, item.lookahead);
+        for (int r = 0; r < static_cast<int>(g.rules.size()); ++r) {
+            if (g.rules[r].lhs != next) continue;
+            for (int t = 0; t < g.terminalCount(); ++t) {
+                if (!((lookaheads >> t) & 1)) continue;
+                const Item added{r, 0, t};
+                if (seen.insert(added).second) items.push_back(added);
+            }
+        }
+    }
+    return ItemSet(seen.begin(), seen.end());
+}
+
+ItemSet Generator::advance(const ItemSet& items, int symbol) const {
+    ItemSet moved;
+    for (const Item& item : items) {
+        const Production& rule = g.rules[item.rule];
+        if (item.dot < static_cast<int>(rule.rhs.size()) && rule.rhs[item.dot] == symbol) {
+            moved.push_back({item.rule, item.dot + 1, item.lookahead});
+        }
+    }
+    return moved.empty() ? moved : closure(moved);
+}
+
+void Generator::buildCanonical() {
+    std::map<ItemSet, int> index;
+    canonical.push_back(closure({{0, 0, g.eof()}}));
+    canonicalGo.emplace_back();
+    index[canonical[0]] = 0;
+    // 按发现顺序编号，初始项目集为 0 号
+    for (std::size_t s = 0; s < canonical.size(); ++s) {
+        for (int symbol = 0; symbol < symbolCount; ++symbol) {
+            ItemSet target = advance(canonical[s], symbol);
+            if (target.empty()) continue;
+            auto found = index.find(target);
+            int id;
+            if (found == index.end()) {
+                id = static_cast<int>(canonical.size());
+                index.emplace(target, id);
+                canonical.push_back(std::move(target));
+                canonicalGo.emplace_back();
+            } else {
+                id = found->second;
+            }
+            canonicalGo[s][symbol] = id;
+        }
+    }
+}
+
+bool Generator::buildTables() {
+    // 合并同心项目集：心相同的规范项目集归为同一个 LALR 状态，向前看集取并集
+    std::map<std::vector<std::pair<int, int>>, int> cores;
+    merged.assign(canonical.size(), -1);
+    for (std::size_t s = 0; s < canonical.size(); ++s) {
+        std::vector<std::pair<int, int>> core;
+        for (const Item& item : canonical[s]) {
+            if (core.empty() || core.back() != std::make_pair(item.rule, item.dot)) {
+                core.emplace_back(item.rule, item.dot);
+            }
+        }
+        auto found = cores.find(core);
+        if (found == cores.end()) {
+            found = cores.emplace(core, static_cast<int>(kernel.size())).first;
+            kernel.emplace_back();
+        }
+        merged[s] = found->second;
+        for (const Item& item : canonical[s]) {
+            kernel[found->second][{item.rule, item.dot}] |= TerminalSet(1) << item.lookahead;
+        }
+    }
+    stateCount = static_cast<int>(kernel.size());
+
+    const int nonterminalCount = static_cast<int>(g.nonterminals.size());
+    action.assign(stateCount, std::vector<int>(g.terminalCount(), 0));
+    go.assign(stateCount, std::vector<int>(nonterminalCount, -1));
+    for (std::size_t s = 0; s < canonical.size(); ++s) {
+        const int state = merged[s];
+        for (const auto& [symbol, target] : canonicalGo[s]) {
+            if (g.isTerminal(symbol)) {
+                action[state][symbol] = merged[target] + 1;
+            } else {
+                go[state][symbol - g.terminalCount()] = merged[target];
+            }
+        }
+    }
+
+    for (int state = 0; state < stateCount; ++state) {
+        for (const auto& [position, lookaheads] : kernel[state]) {
+            const auto [rule, dot] = position;
+            if (dot < static_cast<int>(g.rules[rule].rhs.size())) continue;
+            for (int t = 0; t < g.terminalCount(); ++t) {
+                if (!((lookaheads >> t) & 1)) continue;
+                int& entry = action[state][t];
+                const int reduce = -(rule + 1);
+                if (entry == 0) {
+                    entry = reduce;
+                } else if (entry > 0) {
+                    ++shiftReduce; // 保留移进
+                    std::cerr << "lalrgen: 状态 " << state << " 在 " << g.terminals[t]
+                              << " 上有移进/归约冲突，按移进处理\n";
+                } else if (entry != reduce) {
+                    ++reduceReduce;
+                    std::cerr << "lalrgen: 状态 " << state << " 在 " << g.terminals[t]
+                              << " 上有归约/归约冲突\n";
+                    entry = std::max(entry, reduce); // 保留编号较小的产生式
+                }
+            }
+        }
+    }
+
+    if (reduceReduce > 0 || shiftReduce != g.expected) {
+        std::cerr << "lalrgen: " << shiftReduce << " 个移进/归约冲突（预期 " << g.expected << " 个），"
+                  << reduceReduce << " 个归约/归约冲突\n";
+        return false;
+    }
+    return true;
+}
+
+bool Generator::build() {
+    symbolCount = g.terminalCount() + static_cast<int>(g.nonterminals.size());
+    computeFirst();
+    buildCanonical();
+    return buildTables();
+}
+
+std::string upper(const std::string& name) {
+    std::string result = name;
+    for (char& c : result) {
+        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+    }
+    return result;
+}
+
+void Generator::write(std::ostream& out, const std::string& grammarPath) const {
+    int largest = stateCount;
+    largest = std::max(largest, static_cast<int>(g.rules.size()));
+    const char* entryType = largest < 127 ? "std::int8_t" : "std::int16_t";
+
+    out << "// 由 tools/lalrgen 根据 " << grammarPath << " 生成，请勿手工修改。\n"
+        << "// 修改文法后执行 make lalrtables 重新生成。\n"
+        << "// " << canonical.size() << " 个规范 LR(1) 项目集合并为 " << stateCount << " 个 LALR(1) 状态，"
+        << shiftReduce << " 个移进/归约冲突按移进解决。\n\n"
+        << "#ifndef LALRTABLES_H\n#define LALRTABLES_H\n\n"
+        << "#include <cstdint>\n#include \"token.h\"\n\n"
+        << "namespace lalr {\n\n";
+
+    out << "constexpr int STATE_COUNT = " << stateCount << ";\n"
+        << "constexpr int TERMINAL_COUNT = " << g.terminalCount() << ";\n"
+        << "constexpr int NONTERMINAL_COUNT = " << g.nonterminals.size() << ";\n"
+        << "constexpr int RULE_COUNT = " << g.rules.size() << ";\n\n";
+
+    out << "/// 非终结符。\nenum class Symbol : std::uint8_t {\n";
+    for (const std::string& name : g.nonterminals) out << "    " << upper(name) << ",\n";
+    out << "};\n\n";
+
+    out << "/// 归约时执行的语义动作，NONE 表示把第一个符号的语义值传给左部。\n"
+        << "enum class Reduction : std::uint8_t {\n    NONE,\n";
+    for (const std::string& name : g.actions) out << "    " << name << ",\n";
+    out << "};\n\n";
+
+    out << "/// 产生式：左部、右部长度与语义动作。第 0 条是增广产生式，按它归约即接受。\n"
+        << "struct Rule {\n    Symbol lhs;\n    std::uint8_t length;\n    Reduction action;\n};\n\n"
+        << "constexpr Rule RULES[RULE_COUNT] = {\n";
+    for (std::size_t r = 0; r < g.rules.size(); ++r) {
+        const Production& rule = g.rules[r];
+        const int lhs = r == 0 ? rule.rhs[0] : rule.lhs;
+        std::string text = g.symbolName(rule.lhs) + " ->";
+        for (int symbol : rule.rhs) text += " " + g.symbolName(symbol);
+        if (rule.rhs.empty()) text += " %empty";
+        std::string entry = "    {Symbol::" + upper(g.symbolName(lhs)) + ", " + std::to_string(rule.rhs.size())
+                            + ", Reduction::" + (rule.action.empty() ? "NONE" : rule.action) + "},";
+        entry.resize(std::max<std::size_t>(entry.size() + 1, 56), ' ');
+        out << entry << "// " << r << ": " << text << "\n";
+    }
+    out << "};\n\n";
+
+    out << "/// 动作表的列对应的终结符。\nconstexpr TokenType TERMINALS[TERMINAL_COUNT] = {\n";
+    for (const std::string& name : g.terminals) out << "    TokenType::" << name << ",\n";
+    out << "};\n\n";
+
+    out << "/// 返回终结符在动作表中的列，文法中没有的 Token 返回 -1。\n"
+        << "constexpr int column(TokenType type) {\n    switch (type) {\n";
+    for (int t = 0; t < g.terminalCount(); ++t) {
+        out << "        case TokenType::" << g.terminals[t] << ": return " << t << ";\n";
+    }
+    out << "        default: return -1;\n    }\n}\n\n";
+
+    out << "/// 动作表项：0 为出错，v > 0 为移进并转到状态 v - 1，v < 0 为按第 -v - 1 条产生式归约。\n"
+        << "using Entry = " << entryType << ";\n\n"
+        << "constexpr Entry ACTION[STATE_COUNT][TERMINAL_COUNT] = {\n";
+    for (int state = 0; state < stateCount; ++state) {
+        out << "    {";
+        for (int t = 0; t < g.terminalCount(); ++t) out << (t ? "," : "") << action[state][t];
+        out << "},\n";
+    }
+    out << "};\n\n";
+
+    out << "/// 转移表：归约出非终结符后转到的状态，-1 表示不可能出现。\n"
+        << "constexpr Entry GOTO[STATE_COUNT][NONTERMINAL_COUNT] = {\n";
+    for (int state = 0; state < stateCount; ++state) {
+        out << "    {";
+        for (std::size_t n = 0; n < g.nonterminals.size(); ++n) out << (n ? "," : "") << go[state][n];
+        out << "},\n";
+    }
+    out << "};\n\n} // namespace lalr\n\n#endif // LALRTABLES_H\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "用法: lalrgen <文法文件> <输出头文件>\n";
+        return 2;
+    }
+    Grammar grammar;
+    if (!grammar.load(argv[1])) return 1;
+    Generator generator(grammar);
+    if (!generator.build()) return 1;
+
+    // 先写入字符串，生成成功后才覆盖输出文件
+    std::ostringstream text;
+    std::string grammarPath = argv[1];
+    const std::size_t tools = grammarPath.rfind("tools/");
+    if (tools != std::string::npos) grammarPath.erase(0, tools);
+    generator.write(text, grammarPath);
+    std::ofstream out(argv[2], std::ios::binary);
+    if (!out || !(out << text.str())) {
+        std::cerr << "lalrgen: 无法写入 " << argv[2] << "\n";
+        return 1;
+    }
+    return 0;
+}